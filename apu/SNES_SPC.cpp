@@ -86,6 +86,7 @@ void SNES_SPC::enable_rom( int enable )
 		if ( enable )
 			memcpy( m.hi_ram, &RAM [rom_addr], sizeof m.hi_ram );
 		memcpy( &RAM [rom_addr], (enable ? m.rom : m.hi_ram), rom_size );
+		dsp.ram_written( rom_addr );
 		// TODO: ROM can still get overwritten when DSP writes to echo buffer
 	}
 }
@@ -416,6 +417,7 @@ void SNES_SPC::cpu_write( int data, int addr, rel_time_t time )
 	
 	// RAM
 	RAM [addr] = (uint8_t) data;
+	dsp.ram_written( addr );
 	int reg = addr - 0xF0;
 	if ( reg >= 0 ) // 64%
 	{
@@ -119,6 +119,8 @@ public:
 	void    dsp_set_stereo_switch( int );
 	uint8_t dsp_reg_value( int, int );
 	int     dsp_envx_value( int );
+	void    dsp_enable_brr_cache( bool );
+	void    dsp_brr_cache_stats( unsigned*, unsigned* );
 
 //// Snes9x Debugger
 
@@ -150,6 +150,7 @@ void SNES_SPC::load_regs( uint8_t const in [reg_count] )
 void SNES_SPC::ram_loaded()
 {
 	m.rom_enabled = dsp.rom_enabled = 0;
+	dsp.ram_reloaded();
 	load_regs( &RAM [0xF0] );
 	
 	// Put STOP instruction around memory to catch PC underflow/overflow
@@ -271,6 +272,7 @@ void SNES_SPC::clear_echo()
 		if ( end > 0x10000 )
 			end = 0x10000;
 		memset( &RAM [addr], 0xFF, end - addr );
+		dsp.ram_reloaded();
 	}
 }
 
@@ -422,6 +424,17 @@ int SNES_SPC::dsp_envx_value( int ch )
 	return dsp.envx_value( ch );
 }
 
+void SNES_SPC::dsp_enable_brr_cache( bool enable )
+{
+	dsp.enable_brr_cache( enable );
+}
+
+void SNES_SPC::dsp_brr_cache_stats( unsigned* hits, unsigned* misses )
+{
+	*hits   = dsp.brr_cache_hits;
+	*misses = dsp.brr_cache_misses;
+}
+
 //// Snes9x debugger
 
 #ifdef DEBUGGER
@@ -90,6 +90,7 @@ void SNES_SPC::copy_state( unsigned char** io, copy_func_t copy )
 	// RAM
 	enable_rom( 0 ); // will get re-enabled if necessary in regs_loaded() below
 	copier.copy( RAM, 0x10000 );
+	dsp.ram_reloaded();
 	
 	{
 		// SMP registers
@@ -298,6 +298,51 @@ inline void SPC_DSP::decode_brr( voice_t* v )
 	if ( (v->buf_pos += 4) >= brr_buf_size )
 		v->buf_pos = 0;
 	
+	// Blocks in the direct page and stack are written without going through
+	// cpu_write(), and blocks that wrap past $FFFF span non-adjacent pages
+	brr_cache_t* entry = 0;
+	if ( brr_cache_enabled && (unsigned) (v->brr_addr - 0x200) < 0xFFF8 - 0x200 )
+	{
+		// Blocks are scattered by address; a block's four groups stay together
+		int const slot = (int) (((unsigned) v->brr_addr * 2654435761u) >> brr_cache_hash_shift);
+		entry = &brr_cache [slot * 4 + (v->brr_offset >> 1)];
+		
+		int const page = v->brr_addr >> brr_page_shift;
+		int const last = (v->brr_addr + brr_block_size - 1) >> brr_page_shift;
+		
+		if ( entry->addr == v->brr_addr && entry->offset == v->brr_offset &&
+				entry->header == header &&
+				entry->gen [0] == brr_page_gen [page] && entry->gen [1] == brr_page_gen [last] &&
+				m.t_brr_byte == m.ram [v->brr_addr + v->brr_offset] &&
+				(!(header & 0x0C) || (entry->prev [0] == pos [brr_buf_size - 1] &&
+				entry->prev [1] == pos [brr_buf_size - 2])) )
+		{
+			brr_cache_hits++;
+			for ( int i = 0; i < 4; i++ )
+				pos [i + brr_buf_size] = pos [i] = entry->out [i];
+			return;
+		}
+		
+		brr_cache_misses++;
+		
+		// A write between latching the first byte and now leaves the block
+		// half old, half new; decode it but don't keep it
+		if ( m.t_brr_byte == m.ram [v->brr_addr + v->brr_offset] )
+		{
+			entry->addr    = (BOOST::uint16_t) v->brr_addr;
+			entry->offset  = (uint8_t) v->brr_offset;
+			entry->header  = (uint8_t) header;
+			entry->gen [0] = brr_page_gen [page];
+			entry->gen [1] = brr_page_gen [last];
+			entry->prev [0] = (int16_t) pos [brr_buf_size - 1];
+			entry->prev [1] = (int16_t) pos [brr_buf_size - 2];
+		}
+		else
+		{
+			entry = 0;
+		}
+	}
+	
 	// Decode four samples
 	for ( end = pos + 4; pos < end; pos++, nybbles <<= 4 )
 	{
@@ -340,6 +385,12 @@ inline void SPC_DSP::decode_brr( voice_t* v )
 		s = (int16_t) (s * 2);
 		pos [brr_buf_size] = pos [0] = s; // second copy simplifies wrap-around
 	}
+	
+	if ( entry )
+	{
+		for ( int i = 0; i < 4; i++ )
+			entry->out [i] = (int16_t) pos [i - 4];
+	}
 }
 
 
@@ -724,7 +775,10 @@ inline void SPC_DSP::echo_write( int ch )
 		if ( m.t_echo_ptr >= 0xffc0 && rom_enabled )
 			SET_LE16A( &hi_ram [m.t_echo_ptr + ch * 2 - 0xffc0], m.t_echo_out [ch] );
 		else
+		{
 			SET_LE16A( ECHO_PTR( ch ), m.t_echo_out [ch] );
+			ram_written( m.t_echo_ptr + ch * 2 );
+		}
 	}
 
 	m.t_echo_out [ch] = 0;
@@ -838,6 +892,12 @@ void SPC_DSP::init( void* ram_64k )
 	take_spc_snapshot = 0;
 	spc_snapshot_callback = 0;
 
+	brr_cache_enabled = false;
+	brr_cache_hits = 0;
+	brr_cache_misses = 0;
+	memset( brr_page_gen, 0, sizeof brr_page_gen );
+	memset( brr_cache, 0, sizeof brr_cache );
+
 	#ifndef NDEBUG
 		// be sure this sign-extends
 		assert( (int16_t) 0x8000 == -0x8000 );
@@ -1070,3 +1130,16 @@ int SPC_DSP::envx_value( int ch )
 {
 	return m.voices[ch].env;
 }
+
+void SPC_DSP::enable_brr_cache( bool enable )
+{
+	brr_cache_enabled = enable;
+	ram_reloaded();
+}
+
+// RAM was replaced wholesale (reset, SPC load, state load)
+void SPC_DSP::ram_reloaded( void )
+{
+	for ( int i = 0; i < brr_page_count; i++ )
+		brr_page_gen [i]++;
+}
@@ -79,6 +79,14 @@ public:
 	uint8_t reg_value( int, int );
 	int     envx_value( int );
 
+	// Optional cache of decoded BRR groups, checked against the page write
+	// counters below so it always matches what the decoder would produce
+	unsigned brr_cache_hits;
+	unsigned brr_cache_misses;
+	void    enable_brr_cache( bool );
+	void    ram_written( int addr );
+	void    ram_reloaded( void );
+
 // DSP register addresses
 
 	// Global registers
@@ -246,6 +254,25 @@ private:
 	void echo_30();
 	
 	void soft_reset_common();
+
+	// BRR cache. Entries are direct-mapped on block address and offset and
+	// hold the latched header and, for filtered blocks, the two previous
+	// samples. A write to either 64-byte page the block touches drops them.
+	enum { brr_page_shift = 6 };
+	enum { brr_page_count = 0x10000 >> brr_page_shift };
+	enum { brr_cache_blocks = 1024, brr_cache_hash_shift = 32 - 10 };
+	struct brr_cache_t
+	{
+		unsigned gen [2];
+		BOOST::uint16_t addr;
+		uint8_t offset; // 0 = empty
+		uint8_t header;
+		int16_t prev [2];
+		int16_t out [4];
+	};
+	bool brr_cache_enabled;
+	unsigned brr_page_gen [brr_page_count];
+	brr_cache_t brr_cache [brr_cache_blocks * 4];
 };
 
 #include <assert.h>
@@ -288,6 +315,8 @@ inline void SPC_DSP::write( int addr, int data )
 
 inline void SPC_DSP::mute_voices( int mask ) { m.mute_mask = mask; }
 
+inline void SPC_DSP::ram_written( int addr ) { brr_page_gen [(addr & 0xFFFF) >> brr_page_shift]++; }
+
 inline bool SPC_DSP::check_kon()
 {
 	bool old = m.kon_check;
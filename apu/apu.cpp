@@ -181,6 +181,7 @@
 #include "apu.h"
 #include "snapshot.h"
 #include "display.h"
+#include "profiler.h"
 #include "linear_resampler.h"
 #include "hermite_resampler.h"
 
@@ -218,12 +219,18 @@ namespace spc
 	static int			buffer_size;
 	static int			lag_master      = 0;
 	static int			lag             = 0;
+	static volatile unsigned	clear_request = 0;
+	static unsigned		clear_done      = 0;
 
 	static uint8		*landing_buffer = NULL;
 	static uint8		*shrink_buffer  = NULL;
 
 	static Resampler	*resampler      = NULL;
 
+	static double		base_ratio      = 1.0;
+	static double		fill_average    = 0.5;
+	static volatile int32	rate_adjust = 0;
+
 	static int32		reference_time;
 	static uint32		remainder;
 
@@ -238,7 +245,10 @@ namespace spc
 static void EightBitize (uint8 *, int);
 static void DeStereo (uint8 *, int);
 static void ReverseStereo (uint8 *, int);
+static void ServiceSamples (void);
+static bool8 MixSamples (uint8 *, int);
 static void UpdatePlaybackRate (void);
+static void UpdateDynamicRate (void);
 static void from_apu_to_state (uint8 **, void *, size_t);
 static void to_apu_from_state (uint8 **, void *, size_t);
 static void SPCSnapshotCallback (void);
@@ -280,11 +290,27 @@ static void ReverseStereo (uint8 *src_buffer, int sample_count)
 	}
 }
 
-bool8 S9xMixSamples (uint8 *buffer, int sample_count)
+// Mixing side: carry out the clears the emulation thread asked for, so only
+// this side moves the resampler read position and the lag.
+static void ServiceSamples (void)
+{
+	spc::resampler->service();
+
+	unsigned	request = spc::clear_request;
+	if (request != spc::clear_done)
+	{
+		spc::clear_done = request;
+		spc::lag = spc::lag_master;
+	}
+}
+
+static bool8 MixSamples (uint8 *buffer, int sample_count)
 {
 	static int	shrink_buffer_size = -1;
 	uint8		*dest;
 
+	ServiceSamples();
+
 	if (!Settings.SixteenBitSound || !Settings.Stereo)
 	{
 		/* We still need both stereo samples for generating the mono sample */
@@ -313,6 +339,9 @@ bool8 S9xMixSamples (uint8 *buffer, int sample_count)
 	}
 	else
 	{
+		if (Settings.DynamicRateControl)
+			UpdateDynamicRate();
+
 		if (spc::resampler->avail() >= (sample_count + spc::lag))
 		{
 			spc::resampler->read((short *) dest, sample_count);
@@ -349,11 +378,52 @@ bool8 S9xMixSamples (uint8 *buffer, int sample_count)
 	return (TRUE);
 }
 
+bool8 S9xMixSamples (uint8 *buffer, int sample_count)
+{
+	uint64	start = S9xProfilerMixEnter();
+	bool8	ret = MixSamples(buffer, sample_count);
+	S9xProfilerMixLeave(start);
+
+	return (ret);
+}
+
 int S9xGetSampleCount (void)
 {
+	ServiceSamples();
+
 	return (spc::resampler->avail() >> (Settings.Stereo ? 0 : 1));
 }
 
+// Fill level of the resampler ring, in 16-bit input samples. Safe to call
+// from either the emulation thread or the audio thread.
+void S9xGetSoundBufferLevel (int *filled, int *capacity)
+{
+	if (!spc::resampler)
+	{
+		*filled = *capacity = 0;
+		return;
+	}
+
+	*filled   = spc::resampler->space_filled() >> 1;
+	*capacity = spc::resampler->capacity() >> 1;
+}
+
+// Current dynamic rate control adjustment of the resampling ratio, in ppm.
+int S9xGetDynamicRateAdjust (void)
+{
+	return (spc::rate_adjust);
+}
+
+// Decoded BRR cache lookups since the APU was created.
+void S9xGetBRRCacheStats (uint32 *hits, uint32 *misses)
+{
+	unsigned	h, m;
+
+	spc_core->dsp_brr_cache_stats(&h, &m);
+	*hits   = h;
+	*misses = m;
+}
+
 void S9xFinalizeSamples (void)
 {
 	if (!Settings.Mute)
@@ -390,7 +460,7 @@ void S9xLandSamples (void)
 void S9xClearSamples (void)
 {
 	spc::resampler->clear();
-	spc::lag = spc::lag_master;
+	spc::clear_request++;
 }
 
 bool8 S9xSyncSound (void)
@@ -414,8 +484,27 @@ static void UpdatePlaybackRate (void)
 	if (Settings.SoundInputRate == 0)
 		Settings.SoundInputRate = APU_DEFAULT_INPUT_RATE;
 
-	double time_ratio = (double) Settings.SoundInputRate * spc::timing_hack_numerator / (Settings.SoundPlaybackRate * spc::timing_hack_denominator);
-	spc::resampler->time_ratio(time_ratio);
+	spc::base_ratio = (double) Settings.SoundInputRate * spc::timing_hack_numerator / (Settings.SoundPlaybackRate * spc::timing_hack_denominator);
+	spc::fill_average = 0.5;
+	spc::rate_adjust = 0;
+	spc::resampler->time_ratio(spc::base_ratio);
+}
+
+// Runs on the consumer side of the ring, so the resampler step is only ever
+// changed by the thread that reads it. A filling ring is drained slightly
+// faster and an emptying one slightly slower, by at most DynamicRateLimit
+// tenths of a percent, which keeps the fill level near half without
+// audible pitch change.
+static void UpdateDynamicRate (void)
+{
+	double	fill   = (double) spc::resampler->space_filled() / spc::resampler->capacity();
+	double	adjust;
+
+	spc::fill_average += (fill - spc::fill_average) * 0.05;
+
+	adjust = (2.0 * spc::fill_average - 1.0) * Settings.DynamicRateLimit / 1000.0;
+	spc::resampler->set_ratio(spc::base_ratio * (1.0 + adjust));
+	spc::rate_adjust = (int32) (adjust * 1000000.0);
 }
 
 bool8 S9xInitSound (int buffer_ms, int lag_ms)
@@ -462,6 +551,10 @@ bool8 S9xInitSound (int buffer_ms, int lag_ms)
 	else
 		spc::resampler->resize(spc::buffer_size >> (Settings.SoundSync ? 0 : 1));
 
+	int	simd = S9xResamplerDetectSIMD();
+	spc::resampler->kernel(simd, Settings.SincResampler);
+	printf("Sound resampler: %s %s\n", Settings.SincResampler && simd != RESAMPLER_SIMD_NONE ? "sinc" : "hermite", S9xResamplerSIMDName(simd));
+
 	spc_core->set_output((SNES_SPC::sample_t *) spc::landing_buffer, spc::buffer_size >> 1);
 
 	UpdatePlaybackRate();
@@ -504,6 +597,7 @@ bool8 S9xInitAPU (void)
 	spc_core->init_rom(APUROM);
 
 	spc_core->dsp_set_spc_snapshot_callback(SPCSnapshotCallback);
+	spc_core->dsp_enable_brr_cache(Settings.BRRCache);
 
 	spc::landing_buffer = NULL;
 	spc::shrink_buffer  = NULL;
@@ -553,12 +647,18 @@ static inline int S9xAPUGetClockRemainder (int32 cpucycles)
 
 uint8 S9xAPUReadPort (int port)
 {
-	return ((uint8) spc_core->read_port(S9xAPUGetClock(CPU.Cycles), port));
+	PROFILE_BEGIN(PROF_APU);
+	uint8	byte = (uint8) spc_core->read_port(S9xAPUGetClock(CPU.Cycles), port);
+	PROFILE_END();
+
+	return (byte);
 }
 
 void S9xAPUWritePort (int port, uint8 byte)
 {
+	PROFILE_BEGIN(PROF_APU);
 	spc_core->write_port(S9xAPUGetClock(CPU.Cycles), port, byte);
+	PROFILE_END();
 }
 
 void S9xAPUSetReferenceTime (int32 cpucycles)
@@ -566,14 +666,25 @@ void S9xAPUSetReferenceTime (int32 cpucycles)
 	spc::reference_time = cpucycles;
 }
 
+// Keeps the APU clock in step when CPU.Cycles is rewound at the end of a
+// scanline, so it can run behind by several scanlines.
+void S9xAPURebaseTime (int32 cpucycles)
+{
+	spc::reference_time -= cpucycles;
+}
+
 void S9xAPUExecute (void)
 {
+	PROFILE_BEGIN(PROF_APU);
+
 	/* Accumulate partial APU cycles */
 	spc_core->end_frame(S9xAPUGetClock(CPU.Cycles));
 
 	spc::remainder = S9xAPUGetClockRemainder(CPU.Cycles);
 
 	S9xAPUSetReferenceTime(CPU.Cycles);
+
+	PROFILE_END();
 }
 
 void S9xAPUEndScanline (void)
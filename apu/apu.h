@@ -195,6 +195,7 @@ void S9xAPUWritePort (int, uint8);
 void S9xAPUExecute (void);
 void S9xAPUEndScanline (void);
 void S9xAPUSetReferenceTime (int32);
+void S9xAPURebaseTime (int32);
 void S9xAPUTimingSetSpeedup (int);
 void S9xAPUAllowTimeOverflow (bool);
 void S9xAPULoadState (uint8 *);
@@ -206,6 +207,9 @@ bool8 S9xOpenSoundDevice (void);
 
 bool8 S9xSyncSound (void);
 int S9xGetSampleCount (void);
+void S9xGetSoundBufferLevel (int *, int *);
+int S9xGetDynamicRateAdjust (void);
+void S9xGetBRRCacheStats (uint32 *, uint32 *);
 void S9xSetSoundControl (uint8);
 void S9xSetSoundMute (bool8);
 void S9xLandSamples (void);
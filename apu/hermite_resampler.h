@@ -4,140 +4,200 @@
 #define __HERMITE_RESAMPLER_H
 
 #include "resampler.h"
+#include "resampler_simd.h"
 
 #undef CLAMP
 #undef SHORT_CLAMP
 #define CLAMP(x, low, high) (((x) > (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
 #define SHORT_CLAMP(n) ((short) CLAMP((n), -32768, 32767))
 
+/* Input is deinterleaved into float scratch in chunks, the output positions
+   for a chunk are planned in the same order as the original per-sample
+   loop, and the planned frames are handed to the batched kernels in
+   resampler_simd.cpp four at a time. */
+
+#define HERMITE_CHUNK_FRAMES 256
+
 class HermiteResampler : public Resampler
 {
     protected:
 
         double r_step;
         double r_frac;
-        int    r_left[4], r_right[4];
+        int    simd;
+        bool   sinc;
+        float  *sinc_table;
+        float  s_left [RESAMPLER_HISTORY + HERMITE_CHUNK_FRAMES];
+        float  s_right[RESAMPLER_HISTORY + HERMITE_CHUNK_FRAMES];
+        int    plan_pos[HERMITE_CHUNK_FRAMES];
+        double plan_mu [HERMITE_CHUNK_FRAMES];
 
-        double
-        hermite (double mu1, double a, double b, double c, double d)
+        void
+        flush (short *data, int count)
         {
-            const double tension = 0.0; //-1 = low, 0 = normal, 1 = high
-            const double bias    = 0.0; //-1 = left, 0 = even, 1 = right
-
-            double mu2, mu3, m0, m1, a0, a1, a2, a3;
-
-            mu2 = mu1 * mu1;
-            mu3 = mu2 * mu1;
+            if (sinc)
+                S9xResampleSinc (simd, s_left, s_right, plan_pos, plan_mu, count, sinc_table, data);
+            else
+                S9xResampleHermite (simd, s_left, s_right, plan_pos, plan_mu, count, data);
+        }
 
-            m0  = (b - a) * (1 + bias) * (1 - tension) / 2;
-            m0 += (c - b) * (1 - bias) * (1 - tension) / 2;
-            m1  = (c - b) * (1 + bias) * (1 - tension) / 2;
-            m1 += (d - c) * (1 - bias) * (1 - tension) / 2;
+        void
+        build_sinc (void)
+        {
+            if (sinc_table)
+                S9xResamplerBuildSinc (sinc_table, MIN (1.0, 1.0 / r_step) * 0.92);
+        }
 
-            a0 = +2 * mu3 - 3 * mu2 + 1;
-            a1 =      mu3 - 2 * mu2 + mu1;
-            a2 =      mu3 -     mu2;
-            a3 = -2 * mu3 + 3 * mu2;
+        void
+        apply_ratio (double ratio)
+        {
+            r_step = ratio;
+            build_sinc ();
+        }
 
-            return (a0 * b) + (a1 * m0) + (a2 * m1) + (a3 * c);
+        void
+        reset (void)
+        {
+            r_frac = 1.0;
+            memset (s_left,  0, sizeof (float) * RESAMPLER_HISTORY);
+            memset (s_right, 0, sizeof (float) * RESAMPLER_HISTORY);
         }
 
     public:
         HermiteResampler (int num_samples) : Resampler (num_samples)
         {
-            clear ();
+            r_step = 1.0;
+            simd = RESAMPLER_SIMD_NONE;
+            sinc = false;
+            sinc_table = NULL;
+            reset ();
         }
 
         ~HermiteResampler ()
         {
+            delete[] sinc_table;
         }
 
+        /* Windowed sinc needs a vector unit to be affordable. Only call
+           while the consumer is stopped. */
         void
-        time_ratio (double ratio)
+        kernel (int simd, bool sinc)
         {
-            r_step = ratio;
-            clear ();
+            this->simd = simd;
+            this->sinc = sinc && simd != RESAMPLER_SIMD_NONE;
+
+            delete[] sinc_table;
+            sinc_table = NULL;
+
+            if (this->sinc)
+            {
+                sinc_table = new float[RESAMPLER_SINC_TABLE];
+                build_sinc ();
+            }
+
+            ring_buffer::clear ();
+            reset ();
         }
 
+        /* Change the ratio without dropping buffered samples */
         void
-        clear (void)
+        set_ratio (double ratio)
         {
-            ring_buffer::clear ();
-            r_frac = 1.0;
-            r_left [0] = r_left [1] = r_left [2] = r_left [3] = 0;
-            r_right[0] = r_right[1] = r_right[2] = r_right[3] = 0;
+            r_step = ratio;
         }
 
         void
         read (short *data, int num_samples)
         {
-            int i_position = start >> 1;
+            int i_position = read_offset () >> 1;
+            int filled = space_filled () >> 1;
             short *internal_buffer = (short *) buffer;
+            int max_samples = buffer_size >> 1;
             int o_position = 0;
             int consumed = 0;
+            const double margin_of_error = 1.0e-10;
 
-            while (o_position < num_samples && consumed < buffer_size)
+            if (fabs (r_step - 1.0) < margin_of_error)
             {
-                int s_left = internal_buffer[i_position];
-                int s_right = internal_buffer[i_position + 1];
-                int max_samples = buffer_size >> 1;
-                const double margin_of_error = 1.0e-10;
-
-                if (fabs(r_step - 1.0) < margin_of_error)
+                while (o_position < num_samples && consumed < filled)
                 {
-                    data[o_position] = (short) s_left;
-                    data[o_position + 1] = (short) s_right;
+                    data[o_position] = internal_buffer[i_position];
+                    data[o_position + 1] = internal_buffer[i_position + 1];
 
                     o_position += 2;
                     i_position += 2;
                     if (i_position >= max_samples)
                         i_position -= max_samples;
                     consumed += 2;
-
-                    continue;
                 }
 
-                while (r_frac <= 1.0 && o_position < num_samples)
-                {
-                    data[o_position]     = SHORT_CLAMP (hermite (r_frac, r_left [0], r_left [1], r_left [2], r_left [3]));
-                    data[o_position + 1] = SHORT_CLAMP (hermite (r_frac, r_right[0], r_right[1], r_right[2], r_right[3]));
-
-                    o_position += 2;
+                consume (consumed << 1);
+                return;
+            }
 
-                    r_frac += r_step;
-                }
+            while (o_position < num_samples && consumed < filled)
+            {
+                int frames = MIN ((filled - consumed) >> 1, HERMITE_CHUNK_FRAMES);
+                int planned = 0;
+                int batch = o_position;
+                int i;
 
-                if (r_frac > 1.0)
+                for (i = 0; i < frames; i++)
                 {
-                    r_left [0] = r_left [1];
-                    r_left [1] = r_left [2];
-                    r_left [2] = r_left [3];
-                    r_left [3] = s_left;
-    
-                    r_right[0] = r_right[1];
-                    r_right[1] = r_right[2];
-                    r_right[2] = r_right[3];
-                    r_right[3] = s_right;                    
-                    
-                    r_frac -= 1.0;
-                    
+                    s_left [RESAMPLER_HISTORY + i] = internal_buffer[i_position];
+                    s_right[RESAMPLER_HISTORY + i] = internal_buffer[i_position + 1];
+
                     i_position += 2;
                     if (i_position >= max_samples)
                         i_position -= max_samples;
-                    consumed += 2;
                 }
+
+                for (i = 0; i < frames && o_position < num_samples; )
+                {
+                    while (r_frac <= 1.0 && o_position < num_samples)
+                    {
+                        plan_pos[planned] = i;
+                        plan_mu [planned] = r_frac;
+
+                        o_position += 2;
+                        r_frac += r_step;
+
+                        if (++planned == HERMITE_CHUNK_FRAMES)
+                        {
+                            flush (data + batch, planned);
+                            batch = o_position;
+                            planned = 0;
+                        }
+                    }
+
+                    if (r_frac > 1.0)
+                    {
+                        r_frac -= 1.0;
+                        i++;
+                    }
+                }
+
+                if (planned)
+                    flush (data + batch, planned);
+
+                /* The last RESAMPLER_HISTORY inputs seed the next chunk */
+                memmove (s_left,  s_left  + i, sizeof (float) * RESAMPLER_HISTORY);
+                memmove (s_right, s_right + i, sizeof (float) * RESAMPLER_HISTORY);
+
+                consumed += i << 1;
+
+                /* Output is full; the rest of the chunk stays in the ring */
+                if (i < frames)
+                    break;
             }
 
-            size -= consumed << 1;
-            start += consumed << 1;
-            if (start >= buffer_size)
-                start -= buffer_size;
+            consume (consumed << 1);
         }
 
         inline int
         avail (void)
         {
-            return (int) floor (((size >> 2) - r_frac) / r_step) * 2;
+            return (int) floor (((space_filled () >> 2) - r_frac) / r_step) * 2;
         }
 };
 
@@ -19,6 +19,14 @@ class LinearResampler : public Resampler
         uint32 f__r_frac;
         int    r_left, r_right;
 
+        void
+        reset (void)
+        {
+            f__r_frac = 0;
+            r_left = 0;
+            r_right = 0;
+        }
+
     public:
         LinearResampler (int num_samples) : Resampler (num_samples)
         {
@@ -29,35 +37,27 @@ class LinearResampler : public Resampler
         {
         }
 
+        /* Change the ratio without dropping buffered samples */
         void
-        time_ratio (double ratio)
+        set_ratio (double ratio)
         {
             if (ratio == 0.0)
                 ratio = 1.0;
             f__r_step = (uint32) (ratio * f__one);
             f__inv_r_step = (uint32) (f__one / ratio);
-            clear ();
-        }
-
-        void
-        clear (void)
-        {
-            ring_buffer::clear ();
-            f__r_frac = 0;
-            r_left = 0;
-            r_right = 0;
         }
 
         void
         read (short *data, int num_samples)
         {
-            int i_position = start >> 1;
+            int i_position = read_offset () >> 1;
+            int filled = space_filled () >> 1;
             short *internal_buffer = (short *) buffer;
             int o_position = 0;
             int consumed = 0;
             int max_samples = (buffer_size >> 1);
 
-            while (o_position < num_samples && consumed < buffer_size)
+            while (o_position < num_samples && consumed < filled)
             {
                 if (f__r_step == f__one)
                 {
@@ -99,16 +99,13 @@ class LinearResampler : public Resampler
                 }
             }
 
-            size -= consumed << 1;
-            start += consumed << 1;
-            if (start >= buffer_size)
-                start -= buffer_size;
+            consume (consumed << 1);
         }
 
         inline int
         avail (void)
         {
-            return (((size >> 2) * f__inv_r_step) - ((f__r_frac * f__inv_r_step) >> f_prec)) >> (f_prec - 1);
+            return (((space_filled () >> 2) * f__inv_r_step) - ((f__r_frac * f__inv_r_step) >> f_prec)) >> (f_prec - 1);
         }
 };
 
@@ -7,18 +7,81 @@
 
 class Resampler : public ring_buffer
 {
+    protected:
+        double next_ratio;
+        volatile unsigned ratio_request;
+        unsigned ratio_done;
+
+        /* Consumer side: forget the interpolation state after a flush */
+        virtual void reset (void)        = 0;
+
+        /* Consumer side: take the ratio passed to time_ratio () */
+        virtual void
+        apply_ratio (double ratio)
+        {
+            set_ratio (ratio);
+        }
+
     public:
-        virtual void clear (void)        = 0;
-        virtual void time_ratio (double) = 0;
+        virtual void set_ratio (double)  = 0;
         virtual void read (short *, int) = 0;
         virtual int  avail (void)        = 0;
     
         Resampler (int num_samples) : ring_buffer (num_samples << 1)
         {
+            next_ratio = 1.0;
+            ratio_request = 0;
+            ratio_done = 0;
+        }
+
+        /* Pick a RESAMPLER_SIMD_* kernel; resamplers without one ignore it */
+        virtual void
+        kernel (int simd, bool sinc)
+        {
+        }
+
+        virtual ~Resampler ()
+        {
+        }
+
+        /* Producer side: drop the buffered samples. The consumer carries it
+           out in service (), so start stays consumer-owned. */
+        void
+        clear (void)
+        {
+            request_flush ();
+        }
+
+        /* Producer side: drop the buffered samples and switch ratio */
+        void
+        time_ratio (double ratio)
+        {
+            next_ratio = ratio;
+            RING_BUFFER_BARRIER ();
+            ratio_request++;
+            request_flush ();
         }
 
-        ~Resampler ()
+        /* Consumer side: carry out clear () and time_ratio (). Call before
+           avail () and read (). Returns true if samples were dropped. */
+        bool
+        service (void)
         {
+            if (!take_flush ())
+                return false;
+
+            unsigned request = ratio_request;
+
+            if (request != ratio_done)
+            {
+                RING_BUFFER_BARRIER ();
+                apply_ratio (next_ratio);
+                ratio_done = request;
+            }
+
+            reset ();
+
+            return true;
         }
 
         inline bool
@@ -32,18 +95,6 @@ class Resampler : public ring_buffer
             return true;
         }
 
-        inline int
-        space_empty (void)
-        {
-            return buffer_size - size;
-        }
-    
-        inline int
-        space_filled (void)
-        {
-            return size;
-        }
-        
         inline int
         max_write (void)
         {
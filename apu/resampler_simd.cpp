@@ -0,0 +1,469 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include "snes9x.h"
+#include "resampler_simd.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RESAMPLER_HAVE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESAMPLER_HAVE_NEON
+#if defined(__linux__) && !defined(__aarch64__)
+#include <elf.h>
+#define RESAMPLER_HWCAP_NEON	(1 << 12)
+#endif
+#endif
+
+#ifndef M_PI
+#define M_PI	3.14159265358979323846
+#endif
+
+#define SINC_CENTRE	(RESAMPLER_SINC_TAPS / 2 - 1)
+
+static inline short ClampSample (double);
+static inline double HermiteScalar (double, double, double, double, double);
+static inline int SincPhase (double);
+static void HermiteScalarBatch (const float *, const float *, const int *, const double *, int, short *);
+static void SincScalarBatch (const float *, const float *, const int *, const double *, int, const float *, short *);
+#ifdef RESAMPLER_HAVE_SSE2
+static void HermiteSSE2 (const float *, const float *, const int *, const double *, int, short *);
+static void SincSSE2 (const float *, const float *, const int *, const double *, int, const float *, short *);
+#endif
+#ifdef RESAMPLER_HAVE_NEON
+static void HermiteNEON (const float *, const float *, const int *, const double *, int, short *);
+static void SincNEON (const float *, const float *, const int *, const double *, int, const float *, short *);
+#endif
+
+
+static inline short ClampSample (double n)
+{
+	return ((short) (n > 32767 ? 32767 : (n < -32768 ? -32768 : n)));
+}
+
+// Same arithmetic as the original HermiteResampler::hermite() with zero
+// tension and bias, so the scalar path stays bit-exact.
+static inline double HermiteScalar (double mu1, double a, double b, double c, double d)
+{
+	double	mu2, mu3, m0, m1, a0, a1, a2, a3;
+
+	mu2 = mu1 * mu1;
+	mu3 = mu2 * mu1;
+
+	m0  = (b - a) / 2;
+	m0 += (c - b) / 2;
+	m1  = (c - b) / 2;
+	m1 += (d - c) / 2;
+
+	a0 = +2 * mu3 - 3 * mu2 + 1;
+	a1 =      mu3 - 2 * mu2 + mu1;
+	a2 =      mu3 -     mu2;
+	a3 = -2 * mu3 + 3 * mu2;
+
+	return ((a0 * b) + (a1 * m0) + (a2 * m1) + (a3 * c));
+}
+
+static inline int SincPhase (double mu)
+{
+	int	phase = (int) (mu * RESAMPLER_SINC_PHASES + 0.5);
+
+	return (phase < 0 ? 0 : (phase > RESAMPLER_SINC_PHASES ? RESAMPLER_SINC_PHASES : phase));
+}
+
+int S9xResamplerDetectSIMD (void)
+{
+	static int	simd = -1;
+
+	if (simd >= 0)
+		return (simd);
+
+	simd = RESAMPLER_SIMD_NONE;
+
+#if defined(RESAMPLER_HAVE_SSE2)
+	// The compiler was already told it may use SSE2 everywhere.
+	simd = RESAMPLER_SIMD_SSE2;
+#elif defined(RESAMPLER_HAVE_NEON)
+	simd = RESAMPLER_SIMD_NEON;
+#ifdef RESAMPLER_HWCAP_NEON
+	// -mfpu=neon builds can still land on a core without NEON; glibc on
+	// the older BeagleBoard images predates getauxval().
+	FILE	*fp = fopen("/proc/self/auxv", "rb");
+
+	if (fp)
+	{
+		unsigned long	entry[2];
+
+		while (fread(entry, sizeof(entry), 1, fp) == 1)
+		{
+			if (entry[0] == AT_HWCAP)
+			{
+				if (!(entry[1] & RESAMPLER_HWCAP_NEON))
+					simd = RESAMPLER_SIMD_NONE;
+				break;
+			}
+		}
+
+		fclose(fp);
+	}
+#endif
+#endif
+
+	return (simd);
+}
+
+const char * S9xResamplerSIMDName (int simd)
+{
+	switch (simd)
+	{
+		case RESAMPLER_SIMD_SSE2:	return ("SSE2");
+		case RESAMPLER_SIMD_NEON:	return ("NEON");
+		default:					return ("scalar");
+	}
+}
+
+// Blackman-windowed sinc, one row of taps per fractional position.
+// mu = 0 lands on tap SINC_CENTRE and mu = 1 on the tap after it. Each row
+// is normalised to unity DC gain.
+void S9xResamplerBuildSinc (float *table, double cutoff)
+{
+	const double	half = RESAMPLER_SINC_TAPS / 2;
+	double			row[RESAMPLER_SINC_TAPS];
+
+	if (cutoff > 1.0)
+		cutoff = 1.0;
+
+	for (int p = 0; p <= RESAMPLER_SINC_PHASES; p++)
+	{
+		double	mu = (double) p / RESAMPLER_SINC_PHASES, sum = 0.0;
+
+		for (int k = 0; k < RESAMPLER_SINC_TAPS; k++)
+		{
+			double	t = k - SINC_CENTRE - mu, s, w;
+
+			if (fabs(t) < 1.0e-9)
+				s = cutoff;
+			else
+				s = sin(M_PI * cutoff * t) / (M_PI * t);
+
+			if (fabs(t) >= half)
+				w = 0.0;
+			else
+				w = 0.42 + 0.5 * cos(M_PI * t / half) + 0.08 * cos(2.0 * M_PI * t / half);
+
+			row[k] = s * w;
+			sum += row[k];
+		}
+
+		for (int k = 0; k < RESAMPLER_SINC_TAPS; k++)
+			table[p * RESAMPLER_SINC_TAPS + k] = (float) (row[k] / sum);
+	}
+}
+
+void S9xResampleHermite (int simd, const float *left, const float *right, const int *pos, const double *mu, int count, short *out)
+{
+	switch (simd)
+	{
+	#ifdef RESAMPLER_HAVE_SSE2
+		case RESAMPLER_SIMD_SSE2:
+			HermiteSSE2(left, right, pos, mu, count, out);
+			return;
+	#endif
+
+	#ifdef RESAMPLER_HAVE_NEON
+		case RESAMPLER_SIMD_NEON:
+			HermiteNEON(left, right, pos, mu, count, out);
+			return;
+	#endif
+
+		default:
+			HermiteScalarBatch(left, right, pos, mu, count, out);
+			return;
+	}
+}
+
+void S9xResampleSinc (int simd, const float *left, const float *right, const int *pos, const double *mu, int count, const float *table, short *out)
+{
+	switch (simd)
+	{
+	#ifdef RESAMPLER_HAVE_SSE2
+		case RESAMPLER_SIMD_SSE2:
+			SincSSE2(left, right, pos, mu, count, table, out);
+			return;
+	#endif
+
+	#ifdef RESAMPLER_HAVE_NEON
+		case RESAMPLER_SIMD_NEON:
+			SincNEON(left, right, pos, mu, count, table, out);
+			return;
+	#endif
+
+		default:
+			SincScalarBatch(left, right, pos, mu, count, table, out);
+			return;
+	}
+}
+
+static void HermiteScalarBatch (const float *left, const float *right, const int *pos, const double *mu, int count, short *out)
+{
+	const int	o = RESAMPLER_HISTORY - 4;
+
+	for (int i = 0; i < count; i++)
+	{
+		const float	*l = left + pos[i] + o, *r = right + pos[i] + o;
+
+		out[i * 2]     = ClampSample(HermiteScalar(mu[i], l[0], l[1], l[2], l[3]));
+		out[i * 2 + 1] = ClampSample(HermiteScalar(mu[i], r[0], r[1], r[2], r[3]));
+	}
+}
+
+static void SincScalarBatch (const float *left, const float *right, const int *pos, const double *mu, int count, const float *table, short *out)
+{
+	for (int i = 0; i < count; i++)
+	{
+		const float	*h = table + SincPhase(mu[i]) * RESAMPLER_SINC_TAPS;
+		const float	*l = left + pos[i], *r = right + pos[i];
+		float		sl = 0.0f, sr = 0.0f;
+
+		for (int k = 0; k < RESAMPLER_SINC_TAPS; k++)
+		{
+			sl += l[k] * h[k];
+			sr += r[k] * h[k];
+		}
+
+		out[i * 2]     = ClampSample(sl);
+		out[i * 2 + 1] = ClampSample(sr);
+	}
+}
+
+#ifdef RESAMPLER_HAVE_SSE2
+
+// Catmull-Rom on four output frames of one channel. w0..w3 hold the four
+// windows as rows and are transposed into a, b, c, d across the outputs.
+static inline __m128 HermiteSSE2Lanes (__m128 w0, __m128 w1, __m128 w2, __m128 w3, __m128 mu)
+{
+	_MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+
+	const __m128	half = _mm_set1_ps(0.5f), one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f);
+	__m128	mu2 = _mm_mul_ps(mu, mu);
+	__m128	mu3 = _mm_mul_ps(mu2, mu);
+	__m128	m0  = _mm_mul_ps(_mm_sub_ps(w2, w0), half);
+	__m128	m1  = _mm_mul_ps(_mm_sub_ps(w3, w1), half);
+	__m128	a0  = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(two, mu3), _mm_mul_ps(three, mu2)), one);
+	__m128	a1  = _mm_add_ps(_mm_sub_ps(mu3, _mm_mul_ps(two, mu2)), mu);
+	__m128	a2  = _mm_sub_ps(mu3, mu2);
+	__m128	a3  = _mm_sub_ps(_mm_mul_ps(three, mu2), _mm_mul_ps(two, mu3));
+
+	return (_mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, w1), _mm_mul_ps(a1, m0)), _mm_add_ps(_mm_mul_ps(a2, m1), _mm_mul_ps(a3, w2))));
+}
+
+// Truncate, saturate to 16 bits and interleave four stereo frames.
+static inline void StoreSSE2 (__m128 l, __m128 r, short *out)
+{
+	__m128i	pl = _mm_packs_epi32(_mm_cvttps_epi32(l), _mm_setzero_si128());
+	__m128i	pr = _mm_packs_epi32(_mm_cvttps_epi32(r), _mm_setzero_si128());
+
+	_mm_storeu_si128((__m128i *) out, _mm_unpacklo_epi16(pl, pr));
+}
+
+static void HermiteSSE2 (const float *left, const float *right, const int *pos, const double *mu, int count, short *out)
+{
+	const int	o = RESAMPLER_HISTORY - 4;
+	int			i;
+
+	for (i = 0; i + 4 <= count; i += 4, out += 8)
+	{
+		__m128	m = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(mu + i)), _mm_cvtpd_ps(_mm_loadu_pd(mu + i + 2)));
+
+		__m128	l = HermiteSSE2Lanes(_mm_loadu_ps(left + pos[i] + o),  _mm_loadu_ps(left + pos[i + 1] + o),
+									 _mm_loadu_ps(left + pos[i + 2] + o),  _mm_loadu_ps(left + pos[i + 3] + o), m);
+		__m128	r = HermiteSSE2Lanes(_mm_loadu_ps(right + pos[i] + o), _mm_loadu_ps(right + pos[i + 1] + o),
+									 _mm_loadu_ps(right + pos[i + 2] + o), _mm_loadu_ps(right + pos[i + 3] + o), m);
+
+		StoreSSE2(l, r, out);
+	}
+
+	if (i < count)
+		HermiteScalarBatch(left, right, pos + i, mu + i, count - i, out);
+}
+
+// Sixteen-tap dot product of one window, left in four partial sums.
+static inline __m128 SincSSE2Dot (const float *x, const float *h)
+{
+	__m128	acc = _mm_mul_ps(_mm_loadu_ps(x), _mm_loadu_ps(h));
+
+	for (int k = 4; k < RESAMPLER_SINC_TAPS; k += 4)
+		acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(x + k), _mm_loadu_ps(h + k)));
+
+	return (acc);
+}
+
+// Horizontal sums of four partial-sum vectors, one per lane.
+static inline __m128 SumSSE2 (__m128 s0, __m128 s1, __m128 s2, __m128 s3)
+{
+	_MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+
+	return (_mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3)));
+}
+
+static void SincSSE2 (const float *left, const float *right, const int *pos, const double *mu, int count, const float *table, short *out)
+{
+	int	i;
+
+	for (i = 0; i + 4 <= count; i += 4, out += 8)
+	{
+		const float	*h0 = table + SincPhase(mu[i])     * RESAMPLER_SINC_TAPS;
+		const float	*h1 = table + SincPhase(mu[i + 1]) * RESAMPLER_SINC_TAPS;
+		const float	*h2 = table + SincPhase(mu[i + 2]) * RESAMPLER_SINC_TAPS;
+		const float	*h3 = table + SincPhase(mu[i + 3]) * RESAMPLER_SINC_TAPS;
+
+		__m128	l = SumSSE2(SincSSE2Dot(left + pos[i], h0),  SincSSE2Dot(left + pos[i + 1], h1),
+							SincSSE2Dot(left + pos[i + 2], h2),  SincSSE2Dot(left + pos[i + 3], h3));
+		__m128	r = SumSSE2(SincSSE2Dot(right + pos[i], h0), SincSSE2Dot(right + pos[i + 1], h1),
+							SincSSE2Dot(right + pos[i + 2], h2), SincSSE2Dot(right + pos[i + 3], h3));
+
+		StoreSSE2(l, r, out);
+	}
+
+	if (i < count)
+		SincScalarBatch(left, right, pos + i, mu + i, count - i, table, out);
+}
+
+#endif
+
+#ifdef RESAMPLER_HAVE_NEON
+
+static inline void TransposeNEON (float32x4_t &w0, float32x4_t &w1, float32x4_t &w2, float32x4_t &w3)
+{
+	float32x4x2_t	t01 = vtrnq_f32(w0, w1);
+	float32x4x2_t	t23 = vtrnq_f32(w2, w3);
+
+	w0 = vcombine_f32(vget_low_f32(t01.val[0]),  vget_low_f32(t23.val[0]));
+	w1 = vcombine_f32(vget_low_f32(t01.val[1]),  vget_low_f32(t23.val[1]));
+	w2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+	w3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+static inline float32x4_t HermiteNEONLanes (float32x4_t w0, float32x4_t w1, float32x4_t w2, float32x4_t w3, float32x4_t mu)
+{
+	TransposeNEON(w0, w1, w2, w3);
+
+	float32x4_t	mu2 = vmulq_f32(mu, mu);
+	float32x4_t	mu3 = vmulq_f32(mu2, mu);
+	float32x4_t	m0  = vmulq_n_f32(vsubq_f32(w2, w0), 0.5f);
+	float32x4_t	m1  = vmulq_n_f32(vsubq_f32(w3, w1), 0.5f);
+	float32x4_t	a0  = vaddq_f32(vsubq_f32(vmulq_n_f32(mu3, 2.0f), vmulq_n_f32(mu2, 3.0f)), vdupq_n_f32(1.0f));
+	float32x4_t	a1  = vaddq_f32(vsubq_f32(mu3, vmulq_n_f32(mu2, 2.0f)), mu);
+	float32x4_t	a2  = vsubq_f32(mu3, mu2);
+	float32x4_t	a3  = vsubq_f32(vmulq_n_f32(mu2, 3.0f), vmulq_n_f32(mu3, 2.0f));
+
+	return (vaddq_f32(vaddq_f32(vmulq_f32(a0, w1), vmulq_f32(a1, m0)), vaddq_f32(vmulq_f32(a2, m1), vmulq_f32(a3, w2))));
+}
+
+static inline void StoreNEON (float32x4_t l, float32x4_t r, short *out)
+{
+	int16x4x2_t	s;
+
+	s.val[0] = vqmovn_s32(vcvtq_s32_f32(l));
+	s.val[1] = vqmovn_s32(vcvtq_s32_f32(r));
+	vst2_s16(out, s);
+}
+
+static void HermiteNEON (const float *left, const float *right, const int *pos, const double *mu, int count, short *out)
+{
+	const int	o = RESAMPLER_HISTORY - 4;
+	int			i;
+
+	for (i = 0; i + 4 <= count; i += 4, out += 8)
+	{
+		float		mf[4] = { (float) mu[i], (float) mu[i + 1], (float) mu[i + 2], (float) mu[i + 3] };
+		float32x4_t	m = vld1q_f32(mf);
+
+		float32x4_t	l = HermiteNEONLanes(vld1q_f32(left + pos[i] + o),  vld1q_f32(left + pos[i + 1] + o),
+										 vld1q_f32(left + pos[i + 2] + o),  vld1q_f32(left + pos[i + 3] + o), m);
+		float32x4_t	r = HermiteNEONLanes(vld1q_f32(right + pos[i] + o), vld1q_f32(right + pos[i + 1] + o),
+										 vld1q_f32(right + pos[i + 2] + o), vld1q_f32(right + pos[i + 3] + o), m);
+
+		StoreNEON(l, r, out);
+	}
+
+	if (i < count)
+		HermiteScalarBatch(left, right, pos + i, mu + i, count - i, out);
+}
+
+static inline float32x4_t SincNEONDot (const float *x, const float *h)
+{
+	float32x4_t	acc = vmulq_f32(vld1q_f32(x), vld1q_f32(h));
+
+	for (int k = 4; k < RESAMPLER_SINC_TAPS; k += 4)
+		acc = vmlaq_f32(acc, vld1q_f32(x + k), vld1q_f32(h + k));
+
+	return (acc);
+}
+
+static inline float32x4_t SumNEON (float32x4_t s0, float32x4_t s1, float32x4_t s2, float32x4_t s3)
+{
+	TransposeNEON(s0, s1, s2, s3);
+
+	return (vaddq_f32(vaddq_f32(s0, s1), vaddq_f32(s2, s3)));
+}
+
+static void SincNEON (const float *left, const float *right, const int *pos, const double *mu, int count, const float *table, short *out)
+{
+	int	i;
+
+	for (i = 0; i + 4 <= count; i += 4, out += 8)
+	{
+		const float	*h0 = table + SincPhase(mu[i])     * RESAMPLER_SINC_TAPS;
+		const float	*h1 = table + SincPhase(mu[i + 1]) * RESAMPLER_SINC_TAPS;
+		const float	*h2 = table + SincPhase(mu[i + 2]) * RESAMPLER_SINC_TAPS;
+		const float	*h3 = table + SincPhase(mu[i + 3]) * RESAMPLER_SINC_TAPS;
+
+		float32x4_t	l = SumNEON(SincNEONDot(left + pos[i], h0),  SincNEONDot(left + pos[i + 1], h1),
+								SincNEONDot(left + pos[i + 2], h2),  SincNEONDot(left + pos[i + 3], h3));
+		float32x4_t	r = SumNEON(SincNEONDot(right + pos[i], h0), SincNEONDot(right + pos[i + 1], h1),
+								SincNEONDot(right + pos[i + 2], h2), SincNEONDot(right + pos[i + 3], h3));
+
+		StoreNEON(l, r, out);
+	}
+
+	if (i < count)
+		SincScalarBatch(left, right, pos + i, mu + i, count - i, table, out);
+}
+
+#endif
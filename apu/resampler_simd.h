@@ -0,0 +1,67 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#ifndef _RESAMPLER_SIMD_H_
+#define _RESAMPLER_SIMD_H_
+
+// Batch kernels for HermiteResampler. The resampler plans which input frame
+// and fraction each output frame uses, then hands a whole batch to one of
+// these so the interpolation runs four output frames at a time.
+//
+// Input is planar float: left[pos[i] + k] and right[pos[i] + k] for
+// k = 0 .. RESAMPLER_HISTORY - 1 is the window for output i, oldest first.
+// Output is interleaved stereo 16-bit, clamped and truncated like the
+// scalar resampler.
+
+#define RESAMPLER_HISTORY		16
+#define RESAMPLER_SINC_TAPS		RESAMPLER_HISTORY
+#define RESAMPLER_SINC_PHASES	256
+#define RESAMPLER_SINC_TABLE	((RESAMPLER_SINC_PHASES + 1) * RESAMPLER_SINC_TAPS)
+
+enum
+{
+	RESAMPLER_SIMD_NONE = 0,
+	RESAMPLER_SIMD_SSE2,
+	RESAMPLER_SIMD_NEON
+};
+
+int S9xResamplerDetectSIMD (void);
+const char * S9xResamplerSIMDName (int);
+void S9xResamplerBuildSinc (float *, double);
+void S9xResampleHermite (int, const float *, const float *, const int *, const double *, int, short *);
+void S9xResampleSinc (int, const float *, const float *, const int *, const double *, int, const float *, short *);
+
+#endif
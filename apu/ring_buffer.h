@@ -1,5 +1,14 @@
 /* Simple byte-based ring buffer. Licensed under public domain (C) BearOso. */
 
+/* Single-producer/single-consumer: push () may run on one thread while
+   pull () or a resampler read () runs on another without a lock. The
+   producer only moves end, the consumer only moves start, and both are
+   kept in [0, 2 * buffer_size) so a full buffer differs from an empty one.
+   The producer drops what it has pushed with request_flush (); the
+   consumer moves start when it next calls take_flush (). clear (),
+   resize () and cache_silence () touch both ends and must only be called
+   while the other side is idle. */
+
 #ifndef __RING_BUFFER_H
 #define __RING_BUFFER_H
 
@@ -8,14 +17,81 @@
 #undef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
+#if defined(__GNUC__)
+#define RING_BUFFER_BARRIER() __sync_synchronize ()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define RING_BUFFER_BARRIER() _ReadWriteBarrier ()
+#else
+#define RING_BUFFER_BARRIER()
+#endif
+
 class ring_buffer
 {
 protected:
-    int size;
     int buffer_size;
-    int start;
+    volatile int start;
+    volatile int end;
+    volatile int flush_end;
+    volatile unsigned flush_request;
+    unsigned flush_done;
     unsigned char *buffer;
 
+    inline int
+    wrap (int position)
+    {
+        return position >= buffer_size ? position - buffer_size : position;
+    }
+
+    inline int
+    advance (int position, int bytes)
+    {
+        position += bytes;
+        return position >= (buffer_size << 1) ? position - (buffer_size << 1) : position;
+    }
+
+    /* Byte offset of the oldest sample, for readers working in place */
+    inline int
+    read_offset (void)
+    {
+        return wrap (start);
+    }
+
+    /* Release bytes read in place back to the producer */
+    inline void
+    consume (int bytes)
+    {
+        RING_BUFFER_BARRIER ();
+        start = advance (start, bytes);
+    }
+
+    /* Consumer: drop up to the end seen by the last request_flush ().
+       Returns false if nothing was requested since the last call. */
+    bool
+    take_flush (void)
+    {
+        unsigned request = flush_request;
+
+        if (request == flush_done)
+            return false;
+
+        RING_BUFFER_BARRIER ();
+
+        int target = flush_end;
+        int skip = target - start;
+
+        if (skip < 0)
+            skip += buffer_size << 1;
+
+        /* Anything further than the filled count was already read past */
+        if (skip <= space_filled ())
+            start = target;
+
+        flush_done = request;
+
+        return true;
+    }
+
 public:
     ring_buffer (int buffer_size)
     {
@@ -23,8 +99,11 @@ public:
         buffer = new unsigned char[this->buffer_size];
         memset (buffer, 0, this->buffer_size);
 
-        size = 0;
         start = 0;
+        end = 0;
+        flush_end = 0;
+        flush_request = 0;
+        flush_done = 0;
     }
 
     ~ring_buffer (void)
@@ -38,15 +117,16 @@ public:
         if (space_empty () < bytes)
             return false;
 
-        int end = (start + size) % buffer_size;
-        int first_write_size = MIN (bytes, buffer_size - end);
+        int write = wrap (end);
+        int first_write_size = MIN (bytes, buffer_size - write);
 
-        memcpy (buffer + end, src, first_write_size);
+        memcpy (buffer + write, src, first_write_size);
 
         if (bytes > first_write_size)
             memcpy (buffer, src + first_write_size, bytes - first_write_size);
 
-        size += bytes;
+        RING_BUFFER_BARRIER ();
+        end = advance (end, bytes);
 
         return true;
     }
@@ -57,13 +137,14 @@ public:
         if (space_filled () < bytes)
             return false;
 
-        memcpy (dst, buffer + start, MIN (bytes, buffer_size - start));
+        int read = wrap (start);
+
+        memcpy (dst, buffer + read, MIN (bytes, buffer_size - read));
 
-        if (bytes > (buffer_size - start))
-            memcpy (dst + (buffer_size - start), buffer, bytes - (buffer_size - start));
+        if (bytes > (buffer_size - read))
+            memcpy (dst + (buffer_size - read), buffer, bytes - (buffer_size - read));
 
-        start = (start + bytes) % buffer_size;
-        size -= bytes;
+        consume (bytes);
 
         return true;
     }
@@ -71,21 +152,39 @@ public:
     inline int
     space_empty (void)
     {
-        return buffer_size - size;
+        return buffer_size - space_filled ();
     }
 
     inline int
     space_filled (void)
     {
-        return size;
+        int filled = end - start;
+
+        RING_BUFFER_BARRIER ();
+
+        return filled < 0 ? filled + (buffer_size << 1) : filled;
+    }
+
+    inline int
+    capacity (void)
+    {
+        return buffer_size;
+    }
+
+    /* Producer: ask the consumer to drop everything pushed so far */
+    void
+    request_flush (void)
+    {
+        flush_end = end;
+        RING_BUFFER_BARRIER ();
+        flush_request++;
     }
 
     void
     clear (void)
     {
-        start = 0;
-        size = 0;
-        memset (buffer, 0, buffer_size);
+        start = end;
+        flush_done = flush_request;
     }
 
     void
@@ -96,15 +195,18 @@ public:
         buffer = new unsigned char[buffer_size];
         memset (buffer, 0, this->buffer_size);
 
-        size = 0;
         start = 0;
+        end = 0;
+        flush_done = flush_request;
     }
 
     inline void
     cache_silence (void)
     {
-        clear ();
-        size = buffer_size;
+        memset (buffer, 0, buffer_size);
+        start = 0;
+        end = buffer_size;
+        flush_done = flush_request;
     }
 };
 
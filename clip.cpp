@@ -188,8 +188,27 @@ static uint8	region_map[6][6] =
 	{ 0,    0,    0,    0,    0, 0x10 }
 };
 
+// Recently computed window sets, keyed by every register that feeds them.
+// HDMA window effects (iris wipes, spotlights) tend to repeat the same sets
+// line after line and frame after frame.
+#define CLIP_CACHE_SIZE	1024
+
+static struct
+{
+	struct
+	{
+		uint32			Key[3];
+		bool8			Used;
+		struct ClipData	Clip[2][6];
+	}	Entry[CLIP_CACHE_SIZE];
+
+	uint32	Hits;
+	uint32	Misses;
+}	ClipCache;
+
 static inline uint8 CalcWindowMask (int, uint8, uint8);
 static inline void StoreWindowRegions (uint8, struct ClipData *, int, int16 *, uint8 *, bool8, bool8 s = FALSE);
+static void ComputeClipWindows (void);
 
 
 static inline uint8 CalcWindowMask (int i, uint8 W1, uint8 W2)
@@ -272,6 +291,58 @@ static inline void StoreWindowRegions (uint8 Mask, struct ClipData *Clip, int n_
 }
 
 void S9xComputeClipWindows (void)
+{
+	uint32	key[3] = { 0, 0, 0 };
+
+	key[0] = PPU.Window1Left | (PPU.Window1Right << 8) | (PPU.Window2Left << 16) | ((uint32) PPU.Window2Right << 24);
+
+	for (int i = 0; i < 6; i++)
+	{
+		uint32	bits = (PPU.ClipWindow1Enable[i] ? 1 : 0) | (PPU.ClipWindow2Enable[i] ? 2 : 0) |
+					   (PPU.ClipWindow1Inside[i] ? 4 : 0) | (PPU.ClipWindow2Inside[i] ? 8 : 0) | ((PPU.ClipWindowOverlapLogic[i] & 3) << 4);
+
+		if (i < 5)
+			key[1] |= bits << (i * 6);
+		else
+			key[2] |= bits;
+	}
+
+	key[2] |= ((Memory.FillRAM[0x2130] & 0xf0) << 2) | ((Memory.FillRAM[0x212e] & 0x1f) << 10) | ((Memory.FillRAM[0x212f] & 0x1f) << 15) |
+			  ((Settings.DisableGraphicWindows ? 1 : 0) << 20);
+
+	// Two entries per bucket; a new set goes in front and pushes out the older one.
+	uint32	h = (key[0] * 0x9e3779b1) ^ (key[1] * 0x85ebca77) ^ (key[2] * 0xc2b2ae3d);
+	h ^= h >> 15;
+	h *= 0x2c1b3c6d;
+	h ^= h >> 13;
+	h = (h & (CLIP_CACHE_SIZE / 2 - 1)) * 2;
+
+	for (int way = 0; way < 2; way++)
+	{
+		if (ClipCache.Entry[h + way].Used && !memcmp(ClipCache.Entry[h + way].Key, key, sizeof(key)))
+		{
+			memcpy(IPPU.Clip, ClipCache.Entry[h + way].Clip, sizeof(IPPU.Clip));
+			ClipCache.Hits++;
+			return;
+		}
+	}
+
+	ComputeClipWindows();
+
+	ClipCache.Entry[h + 1] = ClipCache.Entry[h];
+	memcpy(ClipCache.Entry[h].Key, key, sizeof(key));
+	memcpy(ClipCache.Entry[h].Clip, IPPU.Clip, sizeof(IPPU.Clip));
+	ClipCache.Entry[h].Used = TRUE;
+	ClipCache.Misses++;
+}
+
+void S9xGetClipCacheStats (uint32 *hits, uint32 *misses)
+{
+	*hits   = ClipCache.Hits;
+	*misses = ClipCache.Misses;
+}
+
+static void ComputeClipWindows (void)
 {
 	int16	windows[6] = { 0, 256, 256, 256, 256, 256 };
 	uint8	drawing_modes[5] = { 0, 0, 0, 0, 0 };
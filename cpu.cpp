@@ -228,12 +228,25 @@ static void S9xSoftResetCPU (void)
 	CPU.InWRAMDMAorHDMA = FALSE;
 	CPU.HDMARanInDMA = 0;
 	CPU.CurrentDMAorHDMAChannel = -1;
+
+	Timings.InterlaceField = FALSE;
+	Timings.H_Max = Timings.H_Max_Master;
+	Timings.V_Max = Timings.V_Max_Master;
+	Timings.NMITriggerPos = 0xffff;
+	if (Model->_5A22 == 2)
+		Timings.WRAMRefreshPos = SNES_WRAM_REFRESH_HC_v2;
+	else
+		Timings.WRAMRefreshPos = SNES_WRAM_REFRESH_HC_v1;
+
 	CPU.WhichEvent = HC_RENDER_EVENT;
 	CPU.NextEvent  = Timings.RenderPos;
 	CPU.WaitingForInterrupt = FALSE;
 	CPU.AutoSaveTimer = 0;
 	CPU.SRAMModified = FALSE;
 
+	S9xResetIdleLoop();
+	S9xTimelineRestore();
+
 	Registers.PBPC = 0;
 	Registers.PB = 0;
 	Registers.PCw = S9xGetWord(0xfffc);
@@ -250,15 +263,6 @@ static void S9xSoftResetCPU (void)
 	SetFlags(MemoryFlag | IndexFlag | IRQ | Emulation);
 	ClearFlags(Decimal);
 
-	Timings.InterlaceField = FALSE;
-	Timings.H_Max = Timings.H_Max_Master;
-	Timings.V_Max = Timings.V_Max_Master;
-	Timings.NMITriggerPos = 0xffff;
-	if (Model->_5A22 == 2)
-		Timings.WRAMRefreshPos = SNES_WRAM_REFRESH_HC_v2;
-	else
-		Timings.WRAMRefreshPos = SNES_WRAM_REFRESH_HC_v1;
-
 	S9xSetPCBase(Registers.PBPC);
 
 	ICPU.S9xOpcodes = S9xOpcodesE1;
@@ -183,16 +183,24 @@
 #include "apu/apu.h"
 #include "fxemu.h"
 #include "snapshot.h"
+#include "profiler.h"
 #ifdef DEBUGGER
 #include "debug.h"
 #include "missing.h"
 #endif
 
-static inline void S9xReschedule (void);
+static void S9xTimelineScheduleLine (void);
+static inline void S9xTimelineNext (void);
+static bool8 IdleLoopReadable (uint32, int);
+static bool8 IdleLoopBody (uint16, uint16);
+static void IdleLoopSnapshot (void);
+static bool8 IdleLoopUnchanged (void);
 
 
 void S9xMainLoop (void)
 {
+	PROFILE_BEGIN(PROF_CPU);
+
 	for (;;)
 	{
 		if (CPU.NMILine)
@@ -295,9 +303,26 @@ void S9xMainLoop (void)
 		(*Opcodes[Op].S9xOpcode)();
 
 		if (Settings.SA1)
-			S9xSA1MainLoop();
+		{
+			if (Settings.SA1Batch)
+			{
+				// The IRQ line is checked before every opcode, so only bank slots
+				// while $2201 keeps the SA1 from raising it.
+				if (++SA1.BatchSlots >= SA1_BATCH_SLOTS || (Memory.FillRAM[0x2201] & 0xa0))
+					S9xSA1Sync();
+			}
+			else
+			{
+				PROFILE_BEGIN(PROF_SA1);
+				S9xSA1MainLoop();
+				PROFILE_END();
+			}
+		}
 	}
 
+	if (SA1.BatchSlots)
+		S9xSA1Sync();
+
 	S9xPackStatus();
 
 	if (CPU.Flags & SCAN_KEYS_FLAG)
@@ -305,51 +330,281 @@ void S9xMainLoop (void)
 	#ifdef DEBUGGER
 		if (!(CPU.Flags & FRAME_ADVANCE_FLAG))
 	#endif
-		S9xSyncSpeed();
+		{
+			PROFILE_BEGIN(PROF_SYNC);
+			S9xSyncSpeed();
+			PROFILE_END();
+		}
+
 		CPU.Flags &= ~SCAN_KEYS_FLAG;
+		S9xProfilerEndFrame();
 	}
+
+	PROFILE_END();
 }
 
-static inline void S9xReschedule (void)
+// Reads with no side effects whose result can only change at an H event.
+// $4212 also flips its H-blank bit at HBlankEnd, which the caller checks.
+static bool8 IdleLoopReadable (uint32 address, int width)
 {
-	switch (CPU.WhichEvent)
+	for (int i = 0; i < width; i++)
 	{
-		case HC_HBLANK_START_EVENT:
-			CPU.WhichEvent = HC_HDMA_START_EVENT;
-			CPU.NextEvent  = Timings.HDMAStart;
-			break;
+		uint32	a = (address + i) & 0xffffff;
+		uint8	*m = Memory.Map[a >> MEMMAP_SHIFT];
 
-		case HC_HDMA_START_EVENT:
-			CPU.WhichEvent = HC_HCOUNTER_MAX_EVENT;
-			CPU.NextEvent  = Timings.H_Max;
-			break;
+		if (m >= (uint8 *) CMemory::MAP_LAST)
+			continue;
 
-		case HC_HCOUNTER_MAX_EVENT:
-			CPU.WhichEvent = HC_HDMA_INIT_EVENT;
-			CPU.NextEvent  = Timings.HDMAInit;
-			break;
+		if ((pint) m == CMemory::MAP_CPU && width == 1)
+		{
+			if ((a & 0xffff) == 0x4210)
+				continue;
 
-		case HC_HDMA_INIT_EVENT:
-			CPU.WhichEvent = HC_RENDER_EVENT;
-			CPU.NextEvent  = Timings.RenderPos;
-			break;
+			if ((a & 0xffff) == 0x4212)
+			{
+				IdleLoop.ReadsHVBJOY = TRUE;
+				continue;
+			}
+		}
 
-		case HC_RENDER_EVENT:
-			CPU.WhichEvent = HC_WRAM_REFRESH_EVENT;
-			CPU.NextEvent  = Timings.WRAMRefreshPos;
-			break;
+		return (FALSE);
+	}
 
-		case HC_WRAM_REFRESH_EVENT:
-			CPU.WhichEvent = HC_HBLANK_START_EVENT;
-			CPU.NextEvent  = Timings.HBlankStart;
-			break;
+	return (TRUE);
+}
+
+// Accepts a loop body of loads, compares, tests and register transfers with
+// fixed operand addresses, whose branches all stay inside the loop.
+static bool8 IdleLoopBody (uint16 start, uint16 end)
+{
+	uint8	*p = CPU.PCBase;
+	uint16	pc = start;
+
+	IdleLoop.ReadsHVBJOY = FALSE;
+
+	while (pc < end)
+	{
+		uint8	op = p[pc];
+		int		m = CheckMemory() ? 1 : 2;
+		int		x = CheckIndex() ? 1 : 2;
+		uint8	len = ICPU.S9xOpLengths[op];
+
+		if (pc + len > end)
+			return (FALSE);
+
+		uint32	dp  = (Registers.D.W + p[pc + 1]) & 0xffff;
+		uint32	abs = ICPU.ShiftedDB + (p[pc + 1] | ((len > 2 ? p[pc + 2] : 0) << 8));
+		uint32	lng = (abs & 0xffff) | ((len > 3 ? p[pc + 3] : 0) << 16);
+
+		switch (op)
+		{
+			// NOP CLC SEC CLV TAX TAY TXA TYA TXY TYX
+			case 0xea: case 0x18: case 0x38: case 0xb8: case 0xaa:
+			case 0xa8: case 0x8a: case 0x98: case 0x9b: case 0xbb:
+			// LDA LDX LDY CMP CPX CPY BIT AND ORA EOR #imm
+			case 0xa9: case 0xa2: case 0xa0: case 0xc9: case 0xe0:
+			case 0xc0: case 0x89: case 0x29: case 0x09: case 0x49:
+				break;
+
+			// LDA CMP BIT AND ORA EOR dp
+			case 0xa5: case 0xc5: case 0x24: case 0x25: case 0x05: case 0x45:
+				if (!IdleLoopReadable(dp, m))
+					return (FALSE);
+				break;
+
+			// LDX CPX LDY CPY dp
+			case 0xa6: case 0xe4: case 0xa4: case 0xc4:
+				if (!IdleLoopReadable(dp, x))
+					return (FALSE);
+				break;
+
+			// LDA CMP BIT AND ORA EOR abs
+			case 0xad: case 0xcd: case 0x2c: case 0x2d: case 0x0d: case 0x4d:
+				if (!IdleLoopReadable(abs, m))
+					return (FALSE);
+				break;
+
+			// LDX CPX LDY CPY abs
+			case 0xae: case 0xec: case 0xac: case 0xcc:
+				if (!IdleLoopReadable(abs, x))
+					return (FALSE);
+				break;
+
+			// LDA CMP AND ORA EOR long
+			case 0xaf: case 0xcf: case 0x2f: case 0x0f: case 0x4f:
+				if (!IdleLoopReadable(lng, m))
+					return (FALSE);
+				break;
+
+			// BPL BMI BVC BVS BCC BCS BNE BEQ BRA
+			case 0x10: case 0x30: case 0x50: case 0x70: case 0x90:
+			case 0xb0: case 0xd0: case 0xf0: case 0x80:
+			{
+				uint16	target = pc + 2 + (int8) p[pc + 1];
+				if (target < start || target > end)
+					return (FALSE);
+				break;
+			}
+
+			default:
+				return (FALSE);
+		}
+
+		pc += len;
 	}
+
+	return (pc == end);
+}
+
+static void IdleLoopSnapshot (void)
+{
+	IdleLoop.Cycles = CPU.Cycles;
+	IdleLoop.WhichEvent = CPU.WhichEvent;
+	IdleLoop.V_Counter = CPU.V_Counter;
+	IdleLoop.Registers = Registers;
+	IdleLoop._Carry = ICPU._Carry;
+	IdleLoop._Zero = ICPU._Zero;
+	IdleLoop._Negative = ICPU._Negative;
+	IdleLoop._Overflow = ICPU._Overflow;
+	IdleLoop.OpenBus = OpenBus;
+}
+
+static bool8 IdleLoopUnchanged (void)
+{
+	return (CPU.WhichEvent == IdleLoop.WhichEvent && CPU.V_Counter == IdleLoop.V_Counter && CPU.Cycles > IdleLoop.Cycles &&
+		Registers.A.W == IdleLoop.Registers.A.W && Registers.X.W == IdleLoop.Registers.X.W &&
+		Registers.Y.W == IdleLoop.Registers.Y.W && Registers.D.W == IdleLoop.Registers.D.W &&
+		Registers.S.W == IdleLoop.Registers.S.W && Registers.P.W == IdleLoop.Registers.P.W &&
+		Registers.DB == IdleLoop.Registers.DB && Registers.PBPC == IdleLoop.Registers.PBPC &&
+		ICPU._Carry == IdleLoop._Carry && ICPU._Zero == IdleLoop._Zero &&
+		ICPU._Negative == IdleLoop._Negative && ICPU._Overflow == IdleLoop._Overflow &&
+		OpenBus == IdleLoop.OpenBus);
+}
+
+// Called by a taken branch from end back to start, before PC is updated.
+// Once one iteration has run without changing anything, every further
+// iteration up to the next H event would do the same, so they are skipped
+// whole and the loop keeps its exact cycle phase.
+void S9xCheckIdleLoop (uint16 start, uint16 end)
+{
+	if (!CPU.PCBase || Settings.SA1)
+		return;
+
+#ifdef DEBUGGER
+	if (CPU.Flags & TRACE_FLAG)
+		return;
+#endif
+
+	if (IdleLoop.Base != CPU.PCBase || IdleLoop.Start != start || IdleLoop.End != end)
+	{
+		IdleLoop.Base = CPU.PCBase;
+		IdleLoop.Start = start;
+		IdleLoop.End = end;
+		IdleLoop.Valid = (start & ~MEMMAP_MASK) == ((end - 1) & ~MEMMAP_MASK) && IdleLoopBody(start, end);
+		IdleLoopSnapshot();
+		return;
+	}
+
+	if (!IdleLoop.Valid)
+		return;
+
+	if (IdleLoopUnchanged() && !CPU.NMILine && !CPU.IRQTransition && !CPU.IRQExternal &&
+		!PPU.HTimerEnabled && !PPU.VTimerEnabled && IdleLoopBody(start, end) &&
+		(!IdleLoop.ReadsHVBJOY || CPU.Cycles >= Timings.HBlankEnd))
+	{
+		int32	iteration = CPU.Cycles - IdleLoop.Cycles;
+		int32	n = (CPU.NextEvent - 1 - CPU.Cycles) / iteration;
+
+		if (n > 0)
+		{
+			CPU.PrevCycles += n * iteration;
+			CPU.Cycles += n * iteration;
+			IdleLoop.Skips++;
+			IdleLoop.SkippedCycles += n * iteration;
+		}
+	}
+
+	IdleLoopSnapshot();
+}
+
+void S9xResetIdleLoop (void)
+{
+	IdleLoop.Base = NULL;
+	IdleLoop.Valid = FALSE;
+	IdleLoop.Skips = 0;
+	IdleLoop.SkippedCycles = 0;
+}
+
+// Queues every deadline of the scanline that starts now, in time order.
+// Deadlines that share a time run in the order they were queued, so the
+// subsystems that must sync before the scanline rolls over come first.
+static void S9xTimelineScheduleLine (void)
+{
+	Timeline.Head = Timeline.Count = 0;
+
+	S9xTimelineSchedule(HC_HDMA_INIT_EVENT,    Timings.HDMAInit);
+	S9xTimelineSchedule(HC_RENDER_EVENT,       Timings.RenderPos);
+	S9xTimelineSchedule(HC_WRAM_REFRESH_EVENT, Timings.WRAMRefreshPos);
+	S9xTimelineSchedule(HC_HBLANK_START_EVENT, Timings.HBlankStart);
+	S9xTimelineSchedule(HC_HDMA_START_EVENT,   Timings.HDMAStart);
+
+	if (Settings.SuperFX)
+		S9xTimelineSchedule(HC_SUPERFX_EVENT, Timings.H_Max);
+
+	// The APU is only brought up to date every few scanlines and at the
+	// end of the frame; port accesses catch it up in between.
+	if ((CPU.V_Counter + 1) % APU_SYNC_LINES == 0 || CPU.V_Counter + 1 >= Timings.V_Max)
+		S9xTimelineSchedule(HC_APU_SYNC_EVENT, Timings.H_Max);
+
+	S9xTimelineSchedule(HC_HCOUNTER_MAX_EVENT, Timings.H_Max);
+}
+
+static inline void S9xTimelineNext (void)
+{
+	Timeline.Head++;
+	CPU.WhichEvent = Timeline.Queue[Timeline.Head].Event;
+	CPU.NextEvent  = Timeline.Queue[Timeline.Head].Time;
+}
+
+void S9xTimelineSchedule (uint8 event, int32 time)
+{
+	int	i = Timeline.Count;
+
+	if (i >= TIMELINE_MAX_EVENTS)
+		return;
+
+	for (; i > Timeline.Head && Timeline.Queue[i - 1].Time > time; i--)
+		Timeline.Queue[i] = Timeline.Queue[i - 1];
+
+	Timeline.Queue[i].Event = event;
+	Timeline.Queue[i].Time  = time;
+	Timeline.Count++;
+
+	CPU.WhichEvent = Timeline.Queue[Timeline.Head].Event;
+	CPU.NextEvent  = Timeline.Queue[Timeline.Head].Time;
+}
+
+// Rebuilds the queue around CPU.WhichEvent and CPU.NextEvent after a reset
+// or a snapshot load.
+void S9xTimelineRestore (void)
+{
+	uint8	event = CPU.WhichEvent;
+	int32	time  = CPU.NextEvent;
+
+	S9xTimelineScheduleLine();
+
+	while (Timeline.Head < Timeline.Count - 1 && Timeline.Queue[Timeline.Head].Event != event)
+		Timeline.Head++;
+
+	Timeline.Queue[Timeline.Head].Time = time;
+	CPU.WhichEvent = Timeline.Queue[Timeline.Head].Event;
+	CPU.NextEvent  = time;
 }
 
 void S9xDoHEventProcessing (void)
 {
 #ifdef DEBUGGER
-	static char	eventname[7][32] =
+	static char	eventname[9][32] =
 	{
 		"",
 		"HC_HBLANK_START_EVENT",
@@ -357,7 +612,9 @@ void S9xDoHEventProcessing (void)
 		"HC_HCOUNTER_MAX_EVENT",
 		"HC_HDMA_INIT_EVENT   ",
 		"HC_RENDER_EVENT      ",
-		"HC_WRAM_REFRESH_EVENT"
+		"HC_WRAM_REFRESH_EVENT",
+		"HC_APU_SYNC_EVENT    ",
+		"HC_SUPERFX_EVENT     "
 	};
 #endif
 
@@ -367,37 +624,49 @@ void S9xDoHEventProcessing (void)
 			eventname[CPU.WhichEvent], CPU.NextEvent, CPU.Cycles);
 #endif
 
+	PROFILE_BEGIN(PROF_HEVENT);
+
 	switch (CPU.WhichEvent)
 	{
 		case HC_HBLANK_START_EVENT:
-			S9xReschedule();
+			S9xTimelineNext();
 			break;
 
 		case HC_HDMA_START_EVENT:
-			S9xReschedule();
+			S9xTimelineNext();
 
 			if (PPU.HDMA && CPU.V_Counter <= PPU.ScreenHeight)
 			{
 			#ifdef DEBUGGER
 				S9xTraceFormattedMessage("*** HDMA Transfer HC:%04d, Channel:%02x", CPU.Cycles, PPU.HDMA);
 			#endif
+				PROFILE_BEGIN(PROF_DMA);
 				PPU.HDMA = S9xDoHDMA(PPU.HDMA);
+				PROFILE_END();
 			}
 
 			break;
 
-		case HC_HCOUNTER_MAX_EVENT:
-			if (Settings.SuperFX)
-			{
-				if (!SuperFX.oneLineDone)
-					S9xSuperFXExec();
-				SuperFX.oneLineDone = FALSE;
-			}
+		case HC_SUPERFX_EVENT:
+			if (!SuperFX.oneLineDone)
+				S9xSuperFXExec();
+			SuperFX.oneLineDone = FALSE;
+
+			S9xTimelineNext();
+
+			break;
 
+		case HC_APU_SYNC_EVENT:
 			S9xAPUEndScanline();
+
+			S9xTimelineNext();
+
+			break;
+
+		case HC_HCOUNTER_MAX_EVENT:
 			CPU.Cycles -= Timings.H_Max;
 			CPU.PrevCycles -= Timings.H_Max;
-			S9xAPUSetReferenceTime(CPU.Cycles);
+			S9xAPURebaseTime(Timings.H_Max);
 
 			if ((Timings.NMITriggerPos != 0xffff) && (Timings.NMITriggerPos >= Timings.H_Max))
 				Timings.NMITriggerPos -= Timings.H_Max;
@@ -506,19 +775,21 @@ void S9xDoHEventProcessing (void)
 			if (CPU.V_Counter == FIRST_VISIBLE_LINE)	// V=1
 				S9xStartScreenRefresh();
 
-			S9xReschedule();
+			S9xTimelineScheduleLine();
 
 			break;
 
 		case HC_HDMA_INIT_EVENT:
-			S9xReschedule();
+			S9xTimelineNext();
 
 			if (CPU.V_Counter == 0)
 			{
 			#ifdef DEBUGGER
 				S9xTraceFormattedMessage("*** HDMA Init     HC:%04d, Channel:%02x", CPU.Cycles, PPU.HDMA);
 			#endif
+				PROFILE_BEGIN(PROF_DMA);
 				S9xStartHDMA();
+				PROFILE_END();
 			}
 
 			break;
@@ -527,7 +798,7 @@ void S9xDoHEventProcessing (void)
 			if (CPU.V_Counter >= FIRST_VISIBLE_LINE && CPU.V_Counter <= PPU.ScreenHeight)
 				RenderLine((uint8) (CPU.V_Counter - FIRST_VISIBLE_LINE));
 
-			S9xReschedule();
+			S9xTimelineNext();
 
 			break;
 
@@ -540,11 +811,13 @@ void S9xDoHEventProcessing (void)
 			CPU.Cycles += SNES_WRAM_REFRESH_CYCLES;
 			S9xCheckInterrupts();
 
-			S9xReschedule();
+			S9xTimelineNext();
 
 			break;
 	}
 
+	PROFILE_END();
+
 #ifdef DEBUGGER
 	if (Settings.TraceHCEvent)
 		S9xTraceFormattedMessage("--- HC event rescheduled (%s)  expected HC:%04d  current  HC:%04d",
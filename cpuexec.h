@@ -203,7 +203,52 @@ struct SICPU
 	uint32	FrameAdvanceCount;
 };
 
+// Short backward-branch loops that only read WRAM, ROM, $4210 or $4212 are
+// checked for a full iteration that leaves the CPU state unchanged, after
+// which whole iterations are skipped up to the next H event.
+#define IDLE_LOOP_MAX_BYTES		16
+
+struct SIdleLoop
+{
+	uint8	*Base;
+	uint16	Start;
+	uint16	End;
+	bool8	Valid;
+	bool8	ReadsHVBJOY;
+	int32	Cycles;
+	int32	WhichEvent;
+	int32	V_Counter;
+	struct SRegisters	Registers;
+	uint8	_Carry;
+	uint8	_Zero;
+	uint8	_Negative;
+	uint8	_Overflow;
+	uint8	OpenBus;
+	uint32	Skips;
+	uint32	SkippedCycles;
+};
+
+// Every deadline on the current scanline, in CPU cycles and in time order.
+// CPU.WhichEvent and CPU.NextEvent mirror the entry at Head.
+#define TIMELINE_MAX_EVENTS		16
+#define APU_SYNC_LINES			8
+
+struct STimelineEvent
+{
+	int32	Time;
+	uint8	Event;
+};
+
+struct STimeline
+{
+	int		Head;
+	int		Count;
+	struct STimelineEvent	Queue[TIMELINE_MAX_EVENTS];
+};
+
 extern struct SICPU		ICPU;
+extern struct SIdleLoop	IdleLoop;
+extern struct STimeline	Timeline;
 
 extern struct SOpcodes	S9xOpcodesE1[256];
 extern struct SOpcodes	S9xOpcodesM1X1[256];
@@ -220,6 +265,10 @@ void S9xMainLoop (void);
 void S9xReset (void);
 void S9xSoftReset (void);
 void S9xDoHEventProcessing (void);
+void S9xTimelineSchedule (uint8, int32);
+void S9xTimelineRestore (void);
+void S9xCheckIdleLoop (uint16, uint16);
+void S9xResetIdleLoop (void);
 
 static inline void S9xUnpackStatus (void)
 {
@@ -280,7 +280,10 @@ static void Op##OP (void) \
 		if ((Registers.PCw & ~MEMMAP_MASK) != (newPC.W & ~MEMMAP_MASK)) \
 			S9xSetPCBase(ICPU.ShiftedPB + newPC.W); \
 		else \
+		{ \
+			IdleLoopCheck(newPC.W, Registers.PCw); \
 			Registers.PCw = newPC.W; \
+		} \
 	} \
 }
 
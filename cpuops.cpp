@@ -190,8 +190,10 @@
 
 #ifdef SA1_OPCODES
 #define AddCycles(n)	{ SA1.Cycles += (n); }
+#define IdleLoopCheck(start, end)
 #else
 #define AddCycles(n)	{ CPU.PrevCycles = CPU.Cycles; CPU.Cycles += (n); S9xCheckInterrupts(); while (CPU.Cycles >= CPU.NextEvent) S9xDoHEventProcessing(); }
+#define IdleLoopCheck(start, end)	{ if (Settings.IdleLoopSkip && (start) < (end) && (end) - (start) <= IDLE_LOOP_MAX_BYTES) S9xCheckIdleLoop(start, end); }
 #endif
 
 #include "cpuaddr.h"
@@ -2777,6 +2779,9 @@ void S9xOpcode_IRQ (void)
 		AddCycles(2 * SLOW_ONE_CYCLE);
 		S9xSA1SetPCBase(Memory.FillRAM[0x2207] | (Memory.FillRAM[0x2208] << 8));
 	#else
+		if (SA1.BatchSlots)
+			S9xSA1Sync();
+
 		if (Settings.SA1 && (Memory.FillRAM[0x2209] & 0x40))
 		{
 			OpenBus = Memory.FillRAM[0x220f];
@@ -2805,6 +2810,9 @@ void S9xOpcode_IRQ (void)
 		AddCycles(2 * SLOW_ONE_CYCLE);
 		S9xSA1SetPCBase(Memory.FillRAM[0x2207] | (Memory.FillRAM[0x2208] << 8));
 	#else
+		if (SA1.BatchSlots)
+			S9xSA1Sync();
+
 		if (Settings.SA1 && (Memory.FillRAM[0x2209] & 0x40))
 		{
 			OpenBus = Memory.FillRAM[0x220f];
@@ -2852,6 +2860,9 @@ void S9xOpcode_NMI (void)
 		AddCycles(2 * SLOW_ONE_CYCLE);
 		S9xSA1SetPCBase(Memory.FillRAM[0x2205] | (Memory.FillRAM[0x2206] << 8));
 	#else
+		if (SA1.BatchSlots)
+			S9xSA1Sync();
+
 		if (Settings.SA1 && (Memory.FillRAM[0x2209] & 0x10))
 		{
 			OpenBus = Memory.FillRAM[0x220d];
@@ -2880,6 +2891,9 @@ void S9xOpcode_NMI (void)
 		AddCycles(2 * SLOW_ONE_CYCLE);
 		S9xSA1SetPCBase(Memory.FillRAM[0x2205] | (Memory.FillRAM[0x2206] << 8));
 	#else
+		if (SA1.BatchSlots)
+			S9xSA1Sync();
+
 		if (Settings.SA1 && (Memory.FillRAM[0x2209] & 0x10))
 		{
 			OpenBus = Memory.FillRAM[0x220d];
@@ -366,6 +366,10 @@ static uint8 S9xDebugGetByte (uint32 Address)
 			byte = *(Memory.BWRAM + ((Address & 0x7fff) - 0x6000));
 			return (byte);
 
+		case CMemory::MAP_SA1SHARED:
+			byte = *S9xSA1SharedPointer(Address);
+			return (byte);
+
 		default:
 			return (byte);
 	}
@@ -223,6 +223,10 @@ static inline bool8 addCyclesInDMA (uint8 dma_channel)
 
 bool8 S9xDoDMA (uint8 Channel)
 {
+	// DMA reads I-RAM and BW-RAM through base pointers, bypassing the sync in getset.h
+	if (SA1.BatchSlots)
+		S9xSA1Sync();
+
 	CPU.InDMA = TRUE;
     CPU.InDMAorHDMA = TRUE;
 	CPU.CurrentDMAorHDMAChannel = Channel;
@@ -369,6 +373,8 @@ bool8 S9xDoDMA (uint8 Channel)
 			uint32	addr = (d->AAddress / char_line_bytes) * char_line_bytes;
 
 			uint8	*base = S9xGetBasePointer((d->ABank << 16) + addr);
+			if (!base && Settings.SA1Batch && (base = S9xGetMemPointer((d->ABank << 16) + addr)))
+				base -= addr;
 			if (!base)
 			{
 				sprintf(String, "SA-1: DMA from non-block address $%02X:%04X", d->ABank, addr);
@@ -1365,6 +1371,10 @@ static inline bool8 HDMAReadLineCount (int d)
 
 void S9xStartHDMA (void)
 {
+	// HDMA tables are read through base pointers too
+	if (SA1.BatchSlots)
+		S9xSA1Sync();
+
 	PPU.HDMA = Memory.FillRAM[0x420c];
 
 #ifdef DEBUGGER
@@ -1417,6 +1427,9 @@ uint8 S9xDoHDMA (uint8 byte)
 	int32	tmpch;
 	int		d = 0;
 
+	if (SA1.BatchSlots)
+		S9xSA1Sync();
+
 	CPU.InHDMA = TRUE;
 	CPU.InDMAorHDMA = TRUE;
 	CPU.HDMARanInDMA = CPU.InDMA ? byte : 0;
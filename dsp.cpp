@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profiler.h"
 #ifdef DEBUGGER
 #include "missing.h"
 #endif
@@ -212,7 +213,11 @@ uint8 S9xGetDSP (uint16 address)
 	}
 #endif
 
-	return ((*GetDSP)(address));
+	PROFILE_BEGIN(PROF_DSP);
+	uint8	byte = (*GetDSP)(address);
+	PROFILE_END();
+
+	return (byte);
 }
 
 void S9xSetDSP (uint8 byte, uint16 address)
@@ -226,5 +231,7 @@ void S9xSetDSP (uint8 byte, uint16 address)
 	}
 #endif
 
+	PROFILE_BEGIN(PROF_DSP);
 	(*SetDSP)(byte, address);
+	PROFILE_END();
 }
@@ -178,6 +178,8 @@
 
 #include "snes9x.h"
 #include "blit.h"
+#include "blit_simd.h"
+#include "blitthread.h"
 
 #define ALL_COLOR_MASK	(FIRST_COLOR_MASK | SECOND_COLOR_MASK | THIRD_COLOR_MASK)
 
@@ -193,6 +195,25 @@ static uint32	colorMask = 0;
 
 static snes_ntsc_t	*ntsc   = NULL;
 static uint8		*XDelta = NULL;
+static bool8		useSIMD = TRUE;
+#ifdef BLIT_SIMD
+static uint32		*ntscTable = NULL;
+#endif
+
+static void BlitPixSimple2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static void BlitPixTV2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static void BlitPixMixedTV1x2 (uint8 *, int, uint8 *, int, int, int, bool8);
+static void BlitPixSmooth2x2 (uint8 *, int, uint8 *, int, int, int, uint8 *, bool8);
+static void BlitPixNTSC16 (uint8 *, int, uint8 *, int, int, int, int, bool8);
+static void BlitPixBand (void *, uint8 *, int, uint8 *, int, int, int, int, int);
+#ifdef BLIT_SIMD
+static void NTSCNarrowTable (void);
+static void BlitPixSimple2x2SIMD (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static void BlitPixTV2x2SIMD (uint8 *, int, uint8 *, int, int, int, uint8 *);
+static inline void TVPair (uint16 *, uint16 *, uint16 *, int, bool8);
+static void BlitPixNTSC16SIMD (uint8 *, int, uint8 *, int, int, int, int);
+static void BlitPixHiResNTSC16SIMD (uint8 *, int, uint8 *, int, int, int, int);
+#endif
 
 
 bool8 S9xBlitFilterInit (void)
@@ -238,11 +259,20 @@ bool8 S9xBlitNTSCFilterInit (void)
 		return (FALSE);
 
 	snes_ntsc_init(ntsc, &snes_ntsc_composite);
+#ifdef BLIT_SIMD
+	NTSCNarrowTable();
+#endif
 	return (TRUE);
 }
 
 void S9xBlitNTSCFilterDeinit (void)
 {
+#ifdef BLIT_SIMD
+	if (ntscTable && ntscTable != (uint32 *) ntsc->table)
+		free(ntscTable);
+	ntscTable = NULL;
+#endif
+
 	if (ntsc)
 	{
 		free(ntsc);
@@ -253,6 +283,25 @@ void S9xBlitNTSCFilterDeinit (void)
 void S9xBlitNTSCFilterSet (const snes_ntsc_setup_t *setup)
 {
 	snes_ntsc_init(ntsc, setup);
+#ifdef BLIT_SIMD
+	NTSCNarrowTable();
+#endif
+}
+
+const char * S9xBlitSIMDName (void)
+{
+#if defined(BLIT_SIMD_SSE2)
+	return ("SSE2");
+#elif defined(BLIT_SIMD_NEON)
+	return ("NEON");
+#else
+	return (NULL);
+#endif
+}
+
+void S9xBlitSetSIMD (bool8 enable)
+{
+	useSIMD = enable;
 }
 
 void S9xBlitPixSimple1x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
@@ -353,7 +402,19 @@ void S9xBlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 #else
 void S9xBlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-  uint8 *dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+  BlitPixSimple2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta);
+}
+
+static void BlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+#ifdef BLIT_SIMD
+  if (useSIMD)
+  {
+    BlitPixSimple2x2SIMD(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, deltaPtr);
+    return;
+  }
+#endif
+  uint8 *dstPtr2 = dstPtr + dstRowBytes;
   dstRowBytes <<= 1;
   width >>= 1; // AWH
   // AWH - Moved outside of loop
@@ -484,7 +545,20 @@ void S9xBlitPixTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowB
 
 void S9xBlitPixTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+	BlitPixTV2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta);
+}
+
+static void BlitPixTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+#ifdef BLIT_SIMD
+	if (useSIMD)
+	{
+		BlitPixTV2x2SIMD(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, deltaPtr);
+		return;
+	}
+#endif
+
+	uint8	*dstPtr2 = dstPtr + dstRowBytes;
 	dstRowBytes <<= 1;
 
 	for (; height; height--)
@@ -594,11 +668,18 @@ void S9xBlitPixTV2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowB
 }
 
 void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	BlitPixMixedTV1x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, TRUE);
+}
+
+// With last, the final line is the bottom of the frame and has no line below
+// it to mix with.
+static void BlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, bool8 last)
 {
 	uint8	*dstPtr2 = dstPtr + dstRowBytes, *srcPtr2 = srcPtr + srcRowBytes;
 	dstRowBytes <<= 1;
 
-	for (; height > 1; height--)
+	for (; height > (last ? 1 : 0); height--)
 	{
 		uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) dstPtr2, *bP1 = (uint16 *) srcPtr, *bP2 = (uint16 *) srcPtr2;
 		uint16	prev, next, mixed;
@@ -619,6 +700,9 @@ void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int ds
 		dstPtr2 += dstRowBytes;
 	}
 
+	if (!last)
+		return;
+
 	// Last 1 line
 
 	uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) dstPtr2, *bP1 = (uint16 *) srcPtr;
@@ -635,9 +719,17 @@ void S9xBlitPixMixedTV1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int ds
 }
 
 void S9xBlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	BlitPixSmooth2x2(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, XDelta, TRUE);
+}
+
+// Each line is blended with the one above it. Without first, the line above
+// srcPtr belongs to another band: its pixels are rebuilt from the source, and
+// since it isn't known whether it changed, the band's first line is redrawn.
+static void BlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr, bool8 first)
 {
 	/* AWH - BeagleSNES: Added "register" */
-	register uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
+	register uint8	*dstPtr2 = dstPtr + dstRowBytes;
 	uint32	lastLinePix[SNES_WIDTH << 1];
 	uint8	lastLineChg[SNES_WIDTH >> 1];
 	register int		lineBytes = width << 1;
@@ -653,6 +745,28 @@ void S9xBlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 	register uint32  currentPixel, nextPixel, currentDelta, nextDelta, lastPix, lastChg, thisChg, currentPixA, currentPixB, colorA, colorB, colorC;
 	uint16  savePixel;
 
+	if (!first)
+	{
+		uint16	*uP = (uint16 *) (srcPtr - srcRowBytes);
+
+		for (int i = 0; i < (width >> 1); i++)
+		{
+			// Memory order, as the uint32 loads below see it
+			colorA = uP[i * 2];
+			colorB = uP[i * 2 + 1];
+			colorC = (i * 2 + 2 < width) ? uP[i * 2 + 2] : colorB;
+
+		#ifdef MSB_FIRST
+			lastLinePix[i * 2]     = (colorA << 16) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask))      );
+			lastLinePix[i * 2 + 1] = (colorB << 16) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask))      );
+		#else
+			lastLinePix[i * 2]     = (colorA      ) | ((((colorA >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorA & colorB & lowPixelMask)) << 16);
+			lastLinePix[i * 2 + 1] = (colorB      ) | ((((colorC >> 1) & colorMask) + ((colorB >> 1) & colorMask) + (colorC & colorB & lowPixelMask)) << 16);
+		#endif
+			lastLineChg[i] = 1;
+		}
+	}
+
 	for (; height; height--)
 	{
 		/*uint32*/ dP1 = (uint32 *) dstPtr, dP2 = (uint32 *) dstPtr2, bP = (uint32 *) srcPtr, xP = (uint32 *) deltaPtr;
@@ -729,7 +843,6 @@ void S9xBlitPixSmooth2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 		dstPtr2  += dstRowBytes;
 	}
 }
-#if 0 // AWH - BeagleSNES
 void S9xBlitPixSuper2xSaI16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
 	Super2xSaI(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
@@ -747,7 +860,10 @@ void S9xBlitPixSuperEagle16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int
 
 void S9xBlitPixEPX16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	EPX_16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+	if (useSIMD)
+		EPX_16_SIMD(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+	else
+		EPX_16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
 }
 
 void S9xBlitPixHQ2x16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
@@ -764,14 +880,409 @@ void S9xBlitPixHQ4x16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRow
 {
 	HQ4X_16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
 }
-#endif // BeagleSNES
 
 void S9xBlitPixNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	snes_ntsc_blit(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, 0, width, height, dstPtr, dstRowBytes);
+	BlitPixNTSC16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, 0, FALSE);
 }
 
 void S9xBlitPixHiResNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	snes_ntsc_blit_hires(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, 0, width, height, dstPtr, dstRowBytes);
+	BlitPixNTSC16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, 0, TRUE);
+}
+
+static void BlitPixNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int burst, bool8 hires)
+{
+#ifdef BLIT_SIMD
+	if (useSIMD && ntscTable)
+	{
+		if (hires)
+			BlitPixHiResNTSC16SIMD(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, burst);
+		else
+			BlitPixNTSC16SIMD(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, burst);
+		return;
+	}
+#endif
+	if (hires)
+		snes_ntsc_blit_hires(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, burst, width, height, dstPtr, dstRowBytes);
+	else
+		snes_ntsc_blit(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, burst, width, height, dstPtr, dstRowBytes);
+}
+
+// A frame can be drawn in horizontal bands, one call per band, and the bands
+// drawn at the same time. Each band writes only its own output lines and
+// XDelta lines; the lines around it are only read.
+bool8 S9xBlitPixCanSplit (Blitter blit, int srcRowBytes, int width)
+{
+	// S9xBlitPixSmooth2x2() patches the source and XDelta just past the end
+	// of each line, which must not be the start of the next one.
+	if (blit == S9xBlitPixSmooth2x2)
+		return (srcRowBytes >= ((width + 2) << 1));
+
+	return (blit == S9xBlitPixSimple1x1    || blit == S9xBlitPixSimple1x2    || blit == S9xBlitPixSimple2x1    ||
+			blit == S9xBlitPixSimple2x2    || blit == S9xBlitPixBlend1x1     || blit == S9xBlitPixBlend2x1     ||
+			blit == S9xBlitPixTV1x2        || blit == S9xBlitPixTV2x2        || blit == S9xBlitPixMixedTV1x2   ||
+			blit == S9xBlitPixSuperEagle16 || blit == S9xBlitPix2xSaI16      || blit == S9xBlitPixSuper2xSaI16 ||
+			blit == S9xBlitPixEPX16        || blit == S9xBlitPixHQ2x16       || blit == S9xBlitPixHQ3x16       ||
+			blit == S9xBlitPixHQ4x16       || blit == S9xBlitPixNTSC16       || blit == S9xBlitPixHiResNTSC16);
+}
+
+// Draws source lines [top, top + rows) of a width x height frame. srcPtr and
+// dstPtr point at the frame, not the band.
+void S9xBlitPixBand (Blitter blit, uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	uint8	*bandPtr = srcPtr + top * srcRowBytes, *deltaPtr = XDelta + top * srcRowBytes;
+	int		scale = 2;
+
+	if (blit == S9xBlitPixSimple2x2)
+		BlitPixSimple2x2(bandPtr, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, deltaPtr);
+	else
+	if (blit == S9xBlitPixTV2x2)
+		BlitPixTV2x2(bandPtr, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, deltaPtr);
+	else
+	if (blit == S9xBlitPixSmooth2x2)
+		BlitPixSmooth2x2(bandPtr, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, deltaPtr, top == 0);
+	else
+	if (blit == S9xBlitPixMixedTV1x2)
+		BlitPixMixedTV1x2(bandPtr, srcRowBytes, dstPtr + top * 2 * dstRowBytes, dstRowBytes, width, rows, top + rows == height);
+	else
+	if (blit == S9xBlitPixEPX16)
+		EPX_16_Band(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, top, rows, useSIMD);
+	else
+	if (blit == S9xBlitPixNTSC16 || blit == S9xBlitPixHiResNTSC16)
+		BlitPixNTSC16(bandPtr, srcRowBytes, dstPtr + top * dstRowBytes, dstRowBytes, width, rows, top % snes_ntsc_burst_count, blit == S9xBlitPixHiResNTSC16);
+	else
+	{
+		// The rest treat every line alike and read their neighbours in place
+		if (blit == S9xBlitPixSimple1x1 || blit == S9xBlitPixSimple2x1 || blit == S9xBlitPixBlend1x1 || blit == S9xBlitPixBlend2x1)
+			scale = 1;
+		else
+		if (blit == S9xBlitPixHQ3x16)
+			scale = 3;
+		else
+		if (blit == S9xBlitPixHQ4x16)
+			scale = 4;
+
+		blit(bandPtr, srcRowBytes, dstPtr + top * scale * dstRowBytes, dstRowBytes, width, rows);
+	}
+}
+
+// Runs a blitter on the filter thread pool, or in one piece when there is no
+// pool or the blitter can't be split.
+void S9xBlitThreaded (Blitter blit, uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	if (S9xBlitThreadCount() < 2 || !S9xBlitPixCanSplit(blit, srcRowBytes, width))
+	{
+		blit(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+		return;
+	}
+
+	S9xBlitBands(BlitPixBand, &blit, srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+}
+
+static void BlitPixBand (void *data, uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows)
+{
+	S9xBlitPixBand(*(Blitter *) data, srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, top, rows);
+}
+
+#ifdef BLIT_SIMD
+// The 2x kernels below write eight source pixels at a time. XDelta keeps the
+// last pixels drawn, and a block is redrawn when any of them changed, so they
+// write a superset of what the scalar versions do. Everything they skip
+// still holds the same value on screen.
+
+static void BlitPixSimple2x2SIMD (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+
+	for (; height; height--)
+	{
+		uint16	*bP = (uint16 *) srcPtr, *xP = (uint16 *) deltaPtr;
+		uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) (dstPtr + dstRowBytes);
+		int		x;
+
+		for (x = 0; x + 8 <= width; x += 8)
+		{
+			blit_v16	p = BlitLoad(bP + x);
+
+			if (BlitSame(p, BlitLoad(xP + x)))
+				continue;
+
+			blit_v16	lo = BlitZipLo(p, p), hi = BlitZipHi(p, p);
+
+			BlitStore(dP1 + x * 2,     lo);
+			BlitStore(dP1 + x * 2 + 8, hi);
+			BlitStore(dP2 + x * 2,     lo);
+			BlitStore(dP2 + x * 2 + 8, hi);
+			BlitStore(xP + x, p);
+		}
+
+		for (; x < width; x += 2)
+		{
+			if (*(uint32 *) (bP + x) == *(uint32 *) (xP + x))
+				continue;
+
+			dP1[x * 2]     = dP1[x * 2 + 1] = dP2[x * 2]     = dP2[x * 2 + 1] = bP[x];
+			dP1[x * 2 + 2] = dP1[x * 2 + 3] = dP2[x * 2 + 2] = dP2[x * 2 + 3] = bP[x + 1];
+			*(uint32 *) (xP + x) = *(uint32 *) (bP + x);
+		}
+
+		srcPtr   += srcRowBytes;
+		deltaPtr += srcRowBytes;
+		dstPtr   += dstRowBytes << 1;
+	}
+}
+
+// One pair of S9xBlitPixTV2x2(), for the end of a line
+static inline void TVPair (uint16 *bP, uint16 *dP1, uint16 *dP2, int x, bool8 last)
+{
+	uint16	c = (uint16) colorMask;
+	uint16	colorA = bP[x], colorB = bP[x + 1], colorC = last ? colorB : bP[x + 2];
+	uint16	p[4];
+
+	p[0] = colorA;
+	p[1] = ((colorA >> 1) & c) + ((colorB >> 1) & c) + (colorA & colorB & lowPixelMask);
+	p[2] = colorB;
+	p[3] = last ? colorB : ((colorB >> 1) & c) + ((colorC >> 1) & c) + (colorB & colorC & lowPixelMask);
+
+	for (int i = 0; i < 4; i++)
+	{
+		uint16	d1 = (p[i] >> 1) & c, d2 = (d1 >> 1) & c, d3 = (d2 >> 1) & c;
+
+		dP1[x * 2 + i] = p[i];
+		dP2[x * 2 + i] = d1 + d2 + d3;
+	}
+}
+
+static void BlitPixTV2x2SIMD (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, uint8 *deltaPtr)
+{
+	blit_v16	cm = BlitSet((uint16) colorMask), lm = BlitSet(lowPixelMask);
+
+	for (; height; height--)
+	{
+		uint16	*bP = (uint16 *) srcPtr, *xP = (uint16 *) deltaPtr;
+		uint16	*dP1 = (uint16 *) dstPtr, *dP2 = (uint16 *) (dstPtr + dstRowBytes);
+		int		x;
+
+		// Each pixel is followed by its mix with the next one, so a block
+		// also depends on the pair after it.
+		for (x = 0; x + 8 < width; x += 8)
+		{
+			blit_v16	p = BlitLoad(bP + x);
+
+			if (BlitSame(p, BlitLoad(xP + x)) && *(uint32 *) (bP + x + 8) == *(uint32 *) (xP + x + 8))
+				continue;
+
+			blit_v16	n = BlitLoad(bP + x + 1);
+			blit_v16	mix = BlitAdd(BlitAdd(BlitHalf(p, cm), BlitHalf(n, cm)), BlitAnd(BlitAnd(p, n), lm));
+			blit_v16	lo = BlitZipLo(p, mix), hi = BlitZipHi(p, mix);
+			blit_v16	d;
+
+			BlitStore(dP1 + x * 2,     lo);
+			BlitStore(dP1 + x * 2 + 8, hi);
+
+			d = BlitHalf(lo, cm);
+			BlitStore(dP2 + x * 2,     BlitAdd(BlitAdd(d, BlitHalf(d, cm)), BlitHalf(BlitHalf(d, cm), cm)));
+			d = BlitHalf(hi, cm);
+			BlitStore(dP2 + x * 2 + 8, BlitAdd(BlitAdd(d, BlitHalf(d, cm)), BlitHalf(BlitHalf(d, cm), cm)));
+
+			BlitStore(xP + x, p);
+		}
+
+		for (; x < width; x += 2)
+		{
+			bool8	last = (x + 2 >= width);
+
+			if (*(uint32 *) (bP + x) == *(uint32 *) (xP + x) && (last || *(uint32 *) (bP + x + 2) == *(uint32 *) (xP + x + 2)))
+				continue;
+
+			TVPair(bP, dP1, dP2, x, last);
+			*(uint32 *) (xP + x) = *(uint32 *) (bP + x);
+		}
+
+		srcPtr   += srcRowBytes;
+		deltaPtr += srcRowBytes;
+		dstPtr   += dstRowBytes << 1;
+	}
+}
+
+// snes_ntsc with one output pixel per 32-bit lane. The scalar blitters add
+// six kernel entries per pixel (twelve for hires), reading each kernel at a
+// different offset for each of the seven pixels of a chunk; every kernel's
+// part of a chunk is a run of consecutive entries, so it is added to pixels
+// 0-3 and 4-7 with two loads. Pixel 7 is scratch and is overwritten by the
+// next chunk. Only the low 32 bits of an entry reach the output, so this
+// matches the scalar code whatever the size of snes_ntsc_rgb_t.
+
+// A copy of the kernel table in 32-bit entries, where unsigned long is wider
+static void NTSCNarrowTable (void)
+{
+	const snes_ntsc_rgb_t	*table = ntsc->table[0];
+	int						n = snes_ntsc_palette_size * snes_ntsc_entry_size;
+
+	if (sizeof(snes_ntsc_rgb_t) == sizeof(uint32))
+	{
+		ntscTable = (uint32 *) table;
+		return;
+	}
+
+	if (!ntscTable)
+		ntscTable = (uint32 *) malloc(n * sizeof(uint32));
+
+	if (ntscTable)
+	{
+		for (int i = 0; i < n; i++)
+			ntscTable[i] = (uint32) table[i];
+	}
 }
+
+// SNES_NTSC_RGB15() on the 32-bit table
+static inline const uint32 * NTSCKernel (const uint32 *ktable, uint16 n)
+{
+	return (ktable + ((n & 0x001E) | (n & 0x03E0) | (n >> 1 & 0x3C00)) * (snes_ntsc_entry_size / 2));
+}
+
+// SNES_NTSC_CLAMP_() and SNES_NTSC_RGB_OUT_() for 15-bit output
+#define NTSC_OUT(raw, shift) \
+{ \
+	blit_v32	sub = BlitAnd32(BlitShr32(raw, 9 - (shift)), BlitSet32(snes_ntsc_clamp_mask)); \
+	blit_v32	clamp = BlitSub32(BlitSet32(snes_ntsc_clamp_add), sub); \
+	raw = BlitOr32(raw, clamp); \
+	clamp = BlitSub32(clamp, sub); \
+	raw = BlitAnd32(raw, clamp); \
+	raw = BlitOr32(BlitOr32(BlitAnd32(BlitShr32(raw, 14 - (shift)), BlitSet32(0x7C00)), \
+							BlitAnd32(BlitShr32(raw,  9 - (shift)), BlitSet32(0x03E0))), \
+							BlitAnd32(BlitShr32(raw,  4 - (shift)), BlitSet32(0x001F))); \
+}
+
+// Lanes 0 to n-1 of a run, the rest cleared
+#define NTSC_FIRST(p, n)	BlitDown32(BlitUp32(BlitLoad32(p), 4 - (n)), 4 - (n))
+
+// Stores a chunk; the last one of a line has no pixel 7 to spare
+static inline void NTSCStore (uint16 *out, blit_v16 px, bool8 last)
+{
+	uint16	tail[8];
+
+	if (!last)
+	{
+		BlitStore(out, px);
+		return;
+	}
+
+	BlitStore(tail, px);
+	memcpy(out, tail, snes_ntsc_out_chunk * sizeof(uint16));
+}
+
+static void BlitPixNTSC16SIMD (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int burst)
+{
+	int	chunks = (width - 1) / snes_ntsc_in_chunk;
+
+	for (; height; height--)
+	{
+		const uint16	*in = (const uint16 *) srcPtr;
+		const uint32	*ktable = ntscTable + burst * snes_ntsc_burst_size;
+		const uint32	*black = NTSCKernel(ktable, snes_ntsc_black);
+		uint16			*out = (uint16 *) dstPtr;
+
+		// Kernels of the input pixels, oldest first: km2 and km1 from two
+		// chunks back, k0-k2 from the last chunk and k3-k5 from this one
+		const uint32	*km2 = black, *km1 = black, *k0 = black, *k1 = black, *k2 = NTSCKernel(ktable, in[0]);
+		const uint32	*k3, *k4, *k5;
+
+		in++;
+
+		for (int c = 0; c <= chunks; c++)
+		{
+			bool8	last = (c == chunks);
+
+			k3 = last ? black : NTSCKernel(ktable, in[0]);
+			k4 = last ? black : NTSCKernel(ktable, in[1]);
+			k5 = last ? black : NTSCKernel(ktable, in[2]);
+
+			blit_v32	lo = BlitAdd32(BlitAdd32(BlitAdd32(BlitLoad32(k3), BlitLoad32(k0 + 7)), BlitAdd32(BlitLoad32(k1 + 19), BlitLoad32(k2 + 31))),
+									   BlitAdd32(BlitAdd32(BlitLoad32Lo(km2 + 26), BlitUp32(BlitLoad32Lo(k4 + 14), 2)), BlitLoad32(km1 + 38)));
+			blit_v32	hi = BlitAdd32(BlitAdd32(BlitAdd32(BlitLoad32(k3 + 4), BlitLoad32(k0 + 11)), BlitAdd32(BlitLoad32(k1 + 23), BlitLoad32(k2 + 35))),
+									   BlitAdd32(BlitLoad32(k4 + 16), BlitLoad32(k5 + 28)));
+
+			NTSC_OUT(lo, 1);
+			NTSC_OUT(hi, 1);
+			NTSCStore(out, BlitNarrow32(lo, hi), last);
+
+			km2 = k1;
+			km1 = k2;
+			k0  = k3;
+			k1  = k4;
+			k2  = k5;
+			in  += snes_ntsc_in_chunk;
+			out += snes_ntsc_out_chunk;
+		}
+
+		burst = (burst + 1) % snes_ntsc_burst_count;
+		srcPtr += srcRowBytes;
+		dstPtr += dstRowBytes;
+	}
+}
+
+static void BlitPixHiResNTSC16SIMD (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int burst)
+{
+	int	chunks = (width - 2) / (snes_ntsc_in_chunk * 2);
+
+	for (; height; height--)
+	{
+		const uint16	*in = (const uint16 *) srcPtr;
+		const uint32	*ktable = ntscTable + burst * snes_ntsc_burst_size;
+		const uint32	*black = NTSCKernel(ktable, snes_ntsc_black);
+		uint16			*out = (uint16 *) dstPtr;
+
+		// Kernels of the six input pixels of this chunk (n), the last one
+		// (p) and the one before (o). Kernel i covers fourteen entries from
+		// 14 * (i / 2), starting i pixels into the chunk before its own.
+		const uint32	*o[6], *p[6], *n[6];
+
+		for (int i = 0; i < 6; i++)
+			o[i] = p[i] = black;
+		p[4] = NTSCKernel(ktable, in[0]);
+		p[5] = NTSCKernel(ktable, in[1]);
+		in += 2;
+
+		for (int c = 0; c <= chunks; c++)
+		{
+			bool8	last = (c == chunks);
+
+			for (int i = 0; i < 6; i++)
+				n[i] = last ? black : NTSCKernel(ktable, in[i]);
+
+			blit_v32	lo = BlitAdd32(BlitAdd32(BlitAdd32(BlitLoad32(p[0] +  7), BlitLoad32(p[1] +  6)),
+												 BlitAdd32(BlitLoad32(p[2] + 19), BlitLoad32(p[3] + 18))),
+									   BlitAdd32(BlitLoad32(p[4] + 31), BlitLoad32(p[5] + 30)));
+			lo = BlitAdd32(lo, BlitAdd32(BlitAdd32(BlitLoad32(n[0]), BlitUp32(BlitLoad32(n[1]), 1)),
+										 BlitAdd32(BlitUp32(BlitLoad32(n[2] + 14), 2), BlitUp32(BlitLoad32(n[3] + 14), 3))));
+			lo = BlitAdd32(lo, BlitAdd32(BlitAdd32(NTSC_FIRST(o[1] + 13, 1), NTSC_FIRST(o[2] + 26, 2)),
+										 BlitAdd32(NTSC_FIRST(o[3] + 25, 3), BlitAdd32(BlitLoad32(o[4] + 38), BlitLoad32(o[5] + 37)))));
+
+			blit_v32	hi = BlitAdd32(BlitAdd32(BlitAdd32(BlitLoad32(p[0] + 11), BlitLoad32(p[1] + 10)),
+												 BlitAdd32(BlitLoad32(p[2] + 23), BlitLoad32(p[3] + 22))),
+									   BlitAdd32(BlitLoad32(p[4] + 35), BlitLoad32(p[5] + 34)));
+			hi = BlitAdd32(hi, BlitAdd32(BlitAdd32(BlitLoad32(n[0] + 4), BlitLoad32(n[1] + 3)),
+										 BlitAdd32(BlitLoad32(n[2] + 16), BlitLoad32(n[3] + 15))));
+			hi = BlitAdd32(hi, BlitAdd32(BlitAdd32(BlitLoad32(n[4] + 28), BlitUp32(BlitLoad32(n[5] + 28), 1)), BlitDown32(BlitLoad32(o[5] + 38), 3)));
+
+			NTSC_OUT(lo, 0);
+			NTSC_OUT(hi, 0);
+			NTSCStore(out, BlitNarrow32(lo, hi), last);
+
+			for (int i = 0; i < 6; i++)
+			{
+				o[i] = p[i];
+				p[i] = n[i];
+			}
+
+			in  += snes_ntsc_in_chunk * 2;
+			out += snes_ntsc_out_chunk;
+		}
+
+		burst = (burst + 1) % snes_ntsc_burst_count;
+		srcPtr += srcRowBytes;
+		dstPtr += dstRowBytes;
+	}
+}
+#endif
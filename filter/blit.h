@@ -184,12 +184,16 @@
 #include "hq2x.h"
 #include "snes_ntsc.h"
 
+typedef	void (* Blitter) (uint8 *, int, uint8 *, int, int, int);
+
 bool8 S9xBlitFilterInit (void);
 void S9xBlitFilterDeinit (void);
 void S9xBlitClearDelta (void);
 bool8 S9xBlitNTSCFilterInit (void);
 void S9xBlitNTSCFilterDeinit (void);
 void S9xBlitNTSCFilterSet (const snes_ntsc_setup_t *);
+const char * S9xBlitSIMDName (void);
+void S9xBlitSetSIMD (bool8);
 void S9xBlitPixSimple1x1 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixSimple1x2 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixSimple2x1 (uint8 *, int, uint8 *, int, int, int);
@@ -209,5 +213,8 @@ void S9xBlitPixHQ3x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHQ4x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixNTSC16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHiResNTSC16 (uint8 *, int, uint8 *, int, int, int);
+bool8 S9xBlitPixCanSplit (Blitter, int, int);
+void S9xBlitPixBand (Blitter, uint8 *, int, uint8 *, int, int, int, int, int);
+void S9xBlitThreaded (Blitter, uint8 *, int, uint8 *, int, int, int);
 
 #endif
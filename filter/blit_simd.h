@@ -0,0 +1,144 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#ifndef _BLIT_SIMD_H_
+#define _BLIT_SIMD_H_
+
+// Vector helpers shared by the 2x scalers. A vector is eight 16-bit pixels;
+// masks have every bit of a lane set or clear. All loads and stores are
+// unaligned, since neither the SNES screen nor the SDL surface promise more
+// than 2-byte alignment. The NTSC filter also works on four 32-bit lanes;
+// the lane shifts take constants, so they are macros.
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define BLIT_SIMD_SSE2
+#define BLIT_SIMD
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BLIT_SIMD_NEON
+#define BLIT_SIMD
+#endif
+
+#if defined(BLIT_SIMD_SSE2)
+
+typedef __m128i	blit_v16;
+
+static inline blit_v16 BlitLoad (const void *p)				{ return (_mm_loadu_si128((const __m128i *) p)); }
+static inline void BlitStore (void *p, blit_v16 a)			{ _mm_storeu_si128((__m128i *) p, a); }
+static inline blit_v16 BlitSet (uint16 c)					{ return (_mm_set1_epi16((short) c)); }
+static inline blit_v16 BlitEq (blit_v16 a, blit_v16 b)		{ return (_mm_cmpeq_epi16(a, b)); }
+static inline blit_v16 BlitAnd (blit_v16 a, blit_v16 b)		{ return (_mm_and_si128(a, b)); }
+static inline blit_v16 BlitAndNot (blit_v16 a, blit_v16 b)	{ return (_mm_andnot_si128(b, a)); }
+static inline blit_v16 BlitAdd (blit_v16 a, blit_v16 b)		{ return (_mm_add_epi16(a, b)); }
+static inline blit_v16 BlitHalf (blit_v16 a, blit_v16 mask)	{ return (_mm_and_si128(_mm_srli_epi16(a, 1), mask)); }
+static inline blit_v16 BlitZipLo (blit_v16 a, blit_v16 b)	{ return (_mm_unpacklo_epi16(a, b)); }
+static inline blit_v16 BlitZipHi (blit_v16 a, blit_v16 b)	{ return (_mm_unpackhi_epi16(a, b)); }
+
+static inline blit_v16 BlitSelect (blit_v16 mask, blit_v16 a, blit_v16 b)
+{
+	return (_mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)));
+}
+
+static inline bool BlitSame (blit_v16 a, blit_v16 b)
+{
+	return (_mm_movemask_epi8(_mm_cmpeq_epi16(a, b)) == 0xffff);
+}
+
+typedef __m128i	blit_v32;
+
+static inline blit_v32 BlitLoad32 (const uint32 *p)			{ return (_mm_loadu_si128((const __m128i *) p)); }
+static inline blit_v32 BlitLoad32Lo (const uint32 *p)		{ return (_mm_loadl_epi64((const __m128i *) p)); }
+static inline blit_v32 BlitSet32 (uint32 c)					{ return (_mm_set1_epi32((int) c)); }
+static inline blit_v32 BlitAdd32 (blit_v32 a, blit_v32 b)	{ return (_mm_add_epi32(a, b)); }
+static inline blit_v32 BlitSub32 (blit_v32 a, blit_v32 b)	{ return (_mm_sub_epi32(a, b)); }
+static inline blit_v32 BlitAnd32 (blit_v32 a, blit_v32 b)	{ return (_mm_and_si128(a, b)); }
+static inline blit_v32 BlitOr32 (blit_v32 a, blit_v32 b)	{ return (_mm_or_si128(a, b)); }
+
+// Lanes must fit in 15 bits
+static inline blit_v16 BlitNarrow32 (blit_v32 lo, blit_v32 hi)	{ return (_mm_packs_epi32(lo, hi)); }
+
+#define BlitShr32(a, n)		_mm_srli_epi32(a, n)
+#define BlitUp32(a, n)		_mm_slli_si128(a, (n) * 4)
+#define BlitDown32(a, n)	_mm_srli_si128(a, (n) * 4)
+
+#elif defined(BLIT_SIMD_NEON)
+
+typedef uint16x8_t	blit_v16;
+
+static inline blit_v16 BlitLoad (const void *p)				{ return (vld1q_u16((const uint16 *) p)); }
+static inline void BlitStore (void *p, blit_v16 a)			{ vst1q_u16((uint16 *) p, a); }
+static inline blit_v16 BlitSet (uint16 c)					{ return (vdupq_n_u16(c)); }
+static inline blit_v16 BlitEq (blit_v16 a, blit_v16 b)		{ return (vceqq_u16(a, b)); }
+static inline blit_v16 BlitAnd (blit_v16 a, blit_v16 b)		{ return (vandq_u16(a, b)); }
+static inline blit_v16 BlitAndNot (blit_v16 a, blit_v16 b)	{ return (vbicq_u16(a, b)); }
+static inline blit_v16 BlitAdd (blit_v16 a, blit_v16 b)		{ return (vaddq_u16(a, b)); }
+static inline blit_v16 BlitHalf (blit_v16 a, blit_v16 mask)	{ return (vandq_u16(vshrq_n_u16(a, 1), mask)); }
+static inline blit_v16 BlitZipLo (blit_v16 a, blit_v16 b)	{ return (vzipq_u16(a, b).val[0]); }
+static inline blit_v16 BlitZipHi (blit_v16 a, blit_v16 b)	{ return (vzipq_u16(a, b).val[1]); }
+
+static inline blit_v16 BlitSelect (blit_v16 mask, blit_v16 a, blit_v16 b)
+{
+	return (vbslq_u16(mask, a, b));
+}
+
+static inline bool BlitSame (blit_v16 a, blit_v16 b)
+{
+	uint64x2_t	eq = vreinterpretq_u64_u16(vceqq_u16(a, b));
+
+	return ((vgetq_lane_u64(eq, 0) & vgetq_lane_u64(eq, 1)) == ~(uint64) 0);
+}
+
+typedef uint32x4_t	blit_v32;
+
+static inline blit_v32 BlitLoad32 (const uint32 *p)			{ return (vld1q_u32(p)); }
+static inline blit_v32 BlitLoad32Lo (const uint32 *p)		{ return (vcombine_u32(vld1_u32(p), vdup_n_u32(0))); }
+static inline blit_v32 BlitSet32 (uint32 c)					{ return (vdupq_n_u32(c)); }
+static inline blit_v32 BlitAdd32 (blit_v32 a, blit_v32 b)	{ return (vaddq_u32(a, b)); }
+static inline blit_v32 BlitSub32 (blit_v32 a, blit_v32 b)	{ return (vsubq_u32(a, b)); }
+static inline blit_v32 BlitAnd32 (blit_v32 a, blit_v32 b)	{ return (vandq_u32(a, b)); }
+static inline blit_v32 BlitOr32 (blit_v32 a, blit_v32 b)	{ return (vorrq_u32(a, b)); }
+
+// Lanes must fit in 15 bits
+static inline blit_v16 BlitNarrow32 (blit_v32 lo, blit_v32 hi)	{ return (vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))); }
+
+#define BlitShr32(a, n)		vshrq_n_u32(a, n)
+#define BlitUp32(a, n)		vextq_u32(vdupq_n_u32(0), a, 4 - (n))
+#define BlitDown32(a, n)	vextq_u32(a, vdupq_n_u32(0), n)
+
+#endif
+
+#endif
@@ -0,0 +1,194 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "snes9x.h"
+#include "blitthread.h"
+
+static struct
+{
+	int				Count;			// worker threads; the caller draws a band too
+	bool8			Quit;
+	pthread_mutex_t	Lock;
+	pthread_cond_t	Work;
+	pthread_cond_t	Idle;
+	int				Bands;			// bands in the frame being drawn
+	int				Next;			// next band to hand out
+	int				Done;
+	BlitBand		Band;
+	void			*Data;
+	uint8			*Src;
+	int				SrcRowBytes;
+	uint8			*Dst;
+	int				DstRowBytes;
+	int				Width;
+	int				Height;
+	pthread_t		Thread[MAX_BLIT_THREADS];
+}	BT;
+
+static void * BlitThreadMain (void *);
+static void DrawBands (void);
+
+
+// count is the number of threads drawing bands, including the caller.
+bool8 S9xInitBlitThreads (int count)
+{
+	S9xDeinitBlitThreads();
+
+	if (count > MAX_BLIT_THREADS)
+		count = MAX_BLIT_THREADS;
+	if (count < 2)
+		return (count == 1);
+
+	pthread_mutex_init(&BT.Lock, NULL);
+	pthread_cond_init(&BT.Work, NULL);
+	pthread_cond_init(&BT.Idle, NULL);
+	BT.Quit  = FALSE;
+	BT.Bands = 0;
+	BT.Next  = 0;
+	BT.Done  = 0;
+
+	for (BT.Count = 0; BT.Count < count - 1; BT.Count++)
+	{
+		if (pthread_create(&BT.Thread[BT.Count], NULL, BlitThreadMain, NULL))
+		{
+			S9xDeinitBlitThreads();
+			return (FALSE);
+		}
+	}
+
+	return (TRUE);
+}
+
+void S9xDeinitBlitThreads (void)
+{
+	if (!BT.Count)
+		return;
+
+	pthread_mutex_lock(&BT.Lock);
+	BT.Quit = TRUE;
+	pthread_cond_broadcast(&BT.Work);
+	pthread_mutex_unlock(&BT.Lock);
+
+	for (int i = 0; i < BT.Count; i++)
+		pthread_join(BT.Thread[i], NULL);
+
+	pthread_cond_destroy(&BT.Idle);
+	pthread_cond_destroy(&BT.Work);
+	pthread_mutex_destroy(&BT.Lock);
+	BT.Count = 0;
+}
+
+int S9xBlitThreadCount (void)
+{
+	return (BT.Count + 1);
+}
+
+void S9xBlitBands (BlitBand band, void *data, uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	int	bands = BT.Count + 1;
+
+	if (bands > height / BLIT_BAND_MIN_LINES)
+		bands = height / BLIT_BAND_MIN_LINES;
+
+	if (bands < 2)
+	{
+		band(data, srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, 0, height);
+		return;
+	}
+
+	pthread_mutex_lock(&BT.Lock);
+
+	BT.Band        = band;
+	BT.Data        = data;
+	BT.Src         = srcPtr;
+	BT.SrcRowBytes = srcRowBytes;
+	BT.Dst         = dstPtr;
+	BT.DstRowBytes = dstRowBytes;
+	BT.Width       = width;
+	BT.Height      = height;
+	BT.Bands       = bands;
+	BT.Next        = 0;
+	BT.Done        = 0;
+
+	pthread_cond_broadcast(&BT.Work);
+
+	DrawBands();
+
+	while (BT.Done < BT.Bands)
+		pthread_cond_wait(&BT.Idle, &BT.Lock);
+
+	pthread_mutex_unlock(&BT.Lock);
+}
+
+// Called with the lock held. Draws bands until none are left to hand out.
+static void DrawBands (void)
+{
+	while (BT.Next < BT.Bands)
+	{
+		int	b = BT.Next++;
+		int	top = b * BT.Height / BT.Bands, rows = (b + 1) * BT.Height / BT.Bands - top;
+
+		pthread_mutex_unlock(&BT.Lock);
+
+		BT.Band(BT.Data, BT.Src, BT.SrcRowBytes, BT.Dst, BT.DstRowBytes, BT.Width, BT.Height, top, rows);
+
+		pthread_mutex_lock(&BT.Lock);
+
+		if (++BT.Done == BT.Bands)
+			pthread_cond_broadcast(&BT.Idle);
+	}
+}
+
+static void * BlitThreadMain (void *arg)
+{
+	pthread_mutex_lock(&BT.Lock);
+
+	for (;;)
+	{
+		while (BT.Next == BT.Bands && !BT.Quit)
+			pthread_cond_wait(&BT.Work, &BT.Lock);
+
+		if (BT.Quit)
+			break;
+
+		DrawBands();
+	}
+
+	pthread_mutex_unlock(&BT.Lock);
+
+	return (NULL);
+}
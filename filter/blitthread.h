@@ -0,0 +1,59 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#ifndef _BLITTHREAD_H_
+#define _BLITTHREAD_H_
+
+// A persistent pool of threads that pushes a frame through a scaling filter
+// in horizontal bands, the calling thread drawing one of the bands itself.
+// A band function draws source lines [top, top + rows) of the whole frame:
+// it is passed the frame's buffers, may read the lines either side of its
+// band, and writes only its own output lines. Without a pool the frame is
+// drawn as a single band on the calling thread.
+
+#define MAX_BLIT_THREADS		8
+
+// Bands are at least this many source lines, so small frames use fewer threads
+#define BLIT_BAND_MIN_LINES		16
+
+typedef	void (* BlitBand) (void *, uint8 *, int, uint8 *, int, int, int, int, int);
+
+bool8 S9xInitBlitThreads (int);
+void S9xDeinitBlitThreads (void);
+int S9xBlitThreadCount (void);
+void S9xBlitBands (BlitBand, void *, uint8 *, int, uint8 *, int, int, int);
+
+#endif
@@ -178,7 +178,9 @@
 
 #include "snes9x.h"
 #include "epx.h"
+#include "blit_simd.h"
 
+static inline void EPXPixel (uint16, uint16, uint16, uint16, uint16, uint16 *, uint16 *);
 
 void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
@@ -428,3 +430,79 @@ void EPX_16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int
 	else
 		*dP1 = *dP2 = (colorX << 16) + colorX;
 }
+
+static inline void EPXPixel (uint16 colorA, uint16 colorX, uint16 colorC, uint16 colorD, uint16 colorB, uint16 *dP1, uint16 *dP2)
+{
+	if ((colorA != colorC) && (colorB != colorD))
+	{
+		dP1[0] = (colorD == colorA) ? colorD : colorX;
+		dP1[1] = (colorC == colorD) ? colorC : colorX;
+		dP2[0] = (colorA == colorB) ? colorA : colorX;
+		dP2[1] = (colorB == colorC) ? colorB : colorX;
+	}
+	else
+		dP1[0] = dP1[1] = dP2[0] = dP2[1] = colorX;
+}
+
+// EPX_16() eight pixels at a time. Its edge cases all amount to a missing
+// neighbour taking the centre pixel's colour, so the edge lines and columns
+// go through EPXPixel() with that substitution and the rest is vectorised.
+void EPX_16_SIMD (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+#ifdef BLIT_SIMD
+	EPX_16_Band(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height, 0, height, TRUE);
+#else
+	EPX_16(srcPtr, srcRowBytes, dstPtr, dstRowBytes, width, height);
+#endif
+}
+
+// Lines [top, top + rows) of a width x height frame, for drawing it in bands.
+// Only the frame's own first and last lines are treated as edges.
+void EPX_16_Band (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height, int top, int rows, bool8 simd)
+{
+	srcPtr += top * srcRowBytes;
+	dstPtr += top * dstRowBytes * 2;
+
+	for (int y = top; y < top + rows; y++)
+	{
+		uint16	*sP  = (uint16 *) srcPtr;
+		uint16	*uP  = y ? (uint16 *) (srcPtr - srcRowBytes) : sP;
+		uint16	*lP  = (y < height - 1) ? (uint16 *) (srcPtr + srcRowBytes) : sP;
+		uint16	*dP1 = (uint16 *) dstPtr;
+		uint16	*dP2 = (uint16 *) (dstPtr + dstRowBytes);
+		int		x = 1;
+
+		EPXPixel(sP[0], sP[0], sP[1], uP[0], lP[0], dP1, dP2);
+
+	#ifdef BLIT_SIMD
+		for (; simd && x + 8 < width; x += 8)
+		{
+			blit_v16	colorA = BlitLoad(sP + x - 1), colorX = BlitLoad(sP + x), colorC = BlitLoad(sP + x + 1);
+			blit_v16	colorD = BlitLoad(uP + x), colorB = BlitLoad(lP + x);
+			blit_v16	eqAC = BlitEq(colorA, colorC), eqBD = BlitEq(colorB, colorD);
+
+			#define EPX_PICK(eq, c)	BlitSelect(BlitAndNot(BlitAndNot(eq, eqAC), eqBD), c, colorX)
+
+			blit_v16	p00 = EPX_PICK(BlitEq(colorD, colorA), colorD);
+			blit_v16	p01 = EPX_PICK(BlitEq(colorC, colorD), colorC);
+			blit_v16	p10 = EPX_PICK(BlitEq(colorA, colorB), colorA);
+			blit_v16	p11 = EPX_PICK(BlitEq(colorB, colorC), colorB);
+
+			#undef EPX_PICK
+
+			BlitStore(dP1 + x * 2,     BlitZipLo(p00, p01));
+			BlitStore(dP1 + x * 2 + 8, BlitZipHi(p00, p01));
+			BlitStore(dP2 + x * 2,     BlitZipLo(p10, p11));
+			BlitStore(dP2 + x * 2 + 8, BlitZipHi(p10, p11));
+		}
+	#endif
+
+		for (; x < width - 1; x++)
+			EPXPixel(sP[x - 1], sP[x], sP[x + 1], uP[x], lP[x], dP1 + x * 2, dP2 + x * 2);
+
+		EPXPixel(sP[x - 1], sP[x], sP[x], uP[x], lP[x], dP1 + x * 2, dP2 + x * 2);
+
+		srcPtr += srcRowBytes;
+		dstPtr += dstRowBytes << 1;
+	}
+}
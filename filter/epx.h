@@ -180,5 +180,7 @@
 #define _epx_h_
 
 void EPX_16 (uint8 *, int, uint8 *, int, int, int);
+void EPX_16_SIMD (uint8 *, int, uint8 *, int, int, int);
+void EPX_16_Band (uint8 *, int, uint8 *, int, int, int, int, int, bool8);
 
 #endif
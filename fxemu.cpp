@@ -180,6 +180,7 @@
 #include "memmap.h"
 #include "fxinst.h"
 #include "fxemu.h"
+#include "profiler.h"
 
 static void FxReset (struct FxInfo_s *);
 static void fx_readRegisterSpace (void);
@@ -313,6 +314,8 @@ uint8 S9xGetSuperFX (uint16 address)
 
 void S9xSuperFXExec (void)
 {
+	PROFILE_BEGIN(PROF_SUPERFX);
+
 	if ((Memory.FillRAM[0x3000 + GSU_SFR] & FLG_G) && (Memory.FillRAM[0x3000 + GSU_SCMR] & 0x18) == 0x18)
 	{
 		FxEmulate((Memory.FillRAM[0x3000 + GSU_CLSR] & 1) ? SuperFX.speedPerLine * 2 : SuperFX.speedPerLine);
@@ -321,6 +324,8 @@ void S9xSuperFXExec (void)
 		if ((GSUStatus & (FLG_G | FLG_IRQ)) == FLG_IRQ)
 			CPU.IRQExternal = TRUE;
 	}
+
+	PROFILE_END();
 }
 
 static void FxReset (struct FxInfo_s *psFxInfo)
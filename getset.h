@@ -282,10 +282,19 @@ inline uint8 S9xGetByte (const uint32 Address)
 			return (byte);
 
 		case CMemory::MAP_BWRAM:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			byte = *(Memory.BWRAM + ((Address & 0x7fff) - 0x6000));
 			addCyclesInMemoryAccess;
 			return (byte);
 
+		case CMemory::MAP_SA1SHARED:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
+			byte = *S9xSA1SharedPointer(Address);
+			addCyclesInMemoryAccess;
+			return (byte);
+
 		case CMemory::MAP_DSP:
 			byte = S9xGetDSP(Address & 0xffff);
 			addCyclesInMemoryAccess;
@@ -425,10 +434,19 @@ inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
 			return (word);
 
 		case CMemory::MAP_BWRAM:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			word = READ_WORD(Memory.BWRAM + ((Address & 0x7fff) - 0x6000));
 			addCyclesInMemoryAccess_x2;
 			return (word);
 
+		case CMemory::MAP_SA1SHARED:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
+			word = READ_WORD(S9xSA1SharedPointer(Address));
+			addCyclesInMemoryAccess_x2;
+			return (word);
+
 		case CMemory::MAP_DSP:
 			word  = S9xGetDSP(Address & 0xffff);
 			addCyclesInMemoryAccess;
@@ -552,11 +570,20 @@ inline void S9xSetByte (uint8 Byte, uint32 Address)
 			return;
 
 		case CMemory::MAP_BWRAM:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			*(Memory.BWRAM + ((Address & 0x7fff) - 0x6000)) = Byte;
 			CPU.SRAMModified = TRUE;
 			addCyclesInMemoryAccess;
 			return;
 
+		case CMemory::MAP_SA1SHARED:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
+			*S9xSA1SharedPointer(Address) = Byte;
+			addCyclesInMemoryAccess;
+			return;
+
 		case CMemory::MAP_SA1RAM:
 			*(Memory.SRAM + (Address & 0xffff)) = Byte;
 			addCyclesInMemoryAccess;
@@ -745,11 +772,20 @@ inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NON
 			return;
 
 		case CMemory::MAP_BWRAM:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			WRITE_WORD(Memory.BWRAM + ((Address & 0x7fff) - 0x6000), Word);
 			CPU.SRAMModified = TRUE;
 			addCyclesInMemoryAccess_x2;
 			return;
 
+		case CMemory::MAP_SA1SHARED:
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
+			WRITE_WORD(S9xSA1SharedPointer(Address), Word);
+			addCyclesInMemoryAccess_x2;
+			return;
+
 		case CMemory::MAP_SA1RAM:
 			WRITE_WORD(Memory.SRAM + (Address & 0xffff), Word);
 			addCyclesInMemoryAccess_x2;
@@ -911,13 +947,21 @@ inline void S9xSetPCBase (uint32 Address)
 			return;
 
 		case CMemory::MAP_BWRAM:
-			CPU.PCBase = Memory.BWRAM - 0x6000 - (Address & 0x8000);
+			if (Settings.SA1Batch)
+				CPU.PCBase = NULL;
+			else
+				CPU.PCBase = Memory.BWRAM - 0x6000 - (Address & 0x8000);
 			return;
 
 		case CMemory::MAP_SA1RAM:
 			CPU.PCBase = Memory.SRAM;
 			return;
 
+		case CMemory::MAP_SA1SHARED:
+			// fetch through S9xGetByte so a batched SA1 catches up first
+			CPU.PCBase = NULL;
+			return;
+
 		case CMemory::MAP_SPC7110_ROM:
 			CPU.PCBase = S9xGetBasePointerSPC7110(Address);
 			return;
@@ -966,11 +1010,16 @@ inline uint8 * S9xGetBasePointer (uint32 Address)
 			return (Memory.SRAM + (((Address & 0x7fff) - 0x6000 + ((Address & 0xf0000) >> 3)) & Memory.SRAMMask) - (Address & 0xffff));
 
 		case CMemory::MAP_BWRAM:
+			if (Settings.SA1Batch)
+				return (NULL);
 			return (Memory.BWRAM - 0x6000 - (Address & 0x8000));
 
 		case CMemory::MAP_SA1RAM:
 			return (Memory.SRAM);
 
+		case CMemory::MAP_SA1SHARED:
+			return (NULL);
+
 		case CMemory::MAP_SPC7110_ROM:
 			return (S9xGetBasePointerSPC7110(Address));
 
@@ -1016,6 +1065,9 @@ inline uint8 * S9xGetMemPointer (uint32 Address)
 		case CMemory::MAP_SA1RAM:
 			return (Memory.SRAM + (Address & 0xffff));
 
+		case CMemory::MAP_SA1SHARED:
+			return (S9xSA1SharedPointer(Address));
+
 		case CMemory::MAP_SPC7110_ROM:
 			return (S9xGetBasePointerSPC7110(Address) + (Address & 0xffff));
 
@@ -186,6 +186,7 @@
 #include "screenshot.h"
 #include "font.h"
 #include "display.h"
+#include "profiler.h"
 
 extern struct SCheatData		Cheat;
 extern struct SLineData			LineData[240];
@@ -196,8 +197,17 @@ void S9xComputeClipWindows (void);
 static int	font_width = 8, font_height = 9;
 
 static void SetupOBJ (void);
+static void BinOBJ (int, int, int);
+static void BuildOBJLine (int);
+static void DrawLines (void);
+static void DrawChangedLines (void);
+static uint64 LineSkipFrameHash (void);
+static uint64 LineSkipLineHash (uint64, uint32);
+static uint32 LineSkipVRAMStamp (void);
 static void DrawOBJS (int);
 static void DisplayFrameRate (void);
+static void DisplayProfiler (void);
+static void DrawProfilerBar (const struct SProfilerFrame *, int, int, int);
 // AWH - BeagleSNES static void DisplayPressedKeys (void);
 static void DisplayWatchedAddresses (void);
 static void DisplayStringFromBottom (const char *, int, int, bool);
@@ -212,21 +222,82 @@ static uint16 get_crosshair_color (uint8);
 
 #define TILE_PLUS(t, x)	(((t) & 0xfc00) | ((t + x) & 0x3ff))
 
+// With Settings.SkipUnchangedLines, every line drawn gets a signature of what
+// the renderer reads for it: registers, windows, palette generation, the
+// line's scroll and matrix values, its sprites and the last write to the VRAM
+// it can see. A line that comes round again with the same signature keeps the
+// pixels the previous frame left in GFX.Screen. Anything else that draws on
+// the screen must call S9xInvalidateLines() for the rows it touches.
+
+static struct
+{
+	uint64	Hash[SNES_HEIGHT_EXTENDED];
+	bool8	Valid[SNES_HEIGHT_EXTENDED];
+	bool8	Enabled;
+	uint32	Drawn;
+	uint32	Skipped;
+	uint32	MarkDrawn;
+	uint32	MarkSkipped;
+	uint32	Percent;
+}	LineSkip;
+
+// Sprite lists are kept between calls to SetupOBJ. OAM writes mark the sprites
+// whose position, size or vertical flip changed in IPPU.OBJDirty; only those
+// are moved between lines, and only the lines they left or joined are listed
+// again.
+static struct
+{
+	bool8	Valid;
+	uint8	SizeSelect;
+	uint8	Inc;
+	bool8	Rotation;
+	uint8	FirstSprite;
+	uint8	StartLine;
+	uint8	Y[128];									// first line of each sprite
+	uint8	Lines[128];								// lines it covers, 0 if off screen
+	uint8	Flip[128];								// XORed into the line for V flip
+	uint32	OnLine[SNES_HEIGHT_EXTENDED][4];		// sprites on each line, one bit each
+	uint8	RTOFlags[SNES_HEIGHT_EXTENDED];			// this line only, not yet carried down
+	bool8	LineDirty[SNES_HEIGHT_EXTENDED];
+	uint32	Calls;
+	uint32	Full;
+	uint32	Rebinned;
+	uint32	LinesBuilt;
+}	OBJSetup;
+
+#ifdef __GNUC__
+#define OBJ_LOWEST_BIT(m)	__builtin_ctz(m)
+#else
+static inline int OBJ_LOWEST_BIT (uint32 m)
+{
+	int	n = 0;
+	for (; !(m & 1); m >>= 1)
+		n++;
+	return (n);
+}
+#endif
+
+#define LINE_HASH(h, v)	((h) = ((h) ^ (uint32) (v)) * 0x100000001b3ULL)
+
 
 bool8 S9xGraphicsInit (void)
 {
 	S9xInitTileRenderer();
 	ZeroMemory(BlackColourMap, 256 * sizeof(uint16));
+	S9xInvalidateLines(0, SNES_HEIGHT_EXTENDED - 1);
 
 #ifdef GFX_MULTI_FORMAT
 	if (GFX.BuildPixel == NULL)
 		S9xSetRenderPixelFormat(RGB565);
 #endif
 
+	GFX.VRAM = Memory.VRAM;
+	GFX.FillRAM = Memory.FillRAM;
 	GFX.DoInterlace = 0;
 	GFX.InterlaceFrame = 0;
 	GFX.RealPPL = GFX.Pitch >> 1;
 	IPPU.OBJChanged = TRUE;
+	OBJSetup.Valid = FALSE;
 	IPPU.DirectColourMapsNeedRebuild = TRUE;
 	Settings.BG_Forced = 0;
 	S9xFixColourBrightness();
@@ -303,11 +374,16 @@ bool8 S9xGraphicsInit (void)
 		}
 	}
 
+	if (Settings.RenderThreads && !S9xInitRenderThreads(Settings.RenderThreads))
+		S9xMessage(S9X_WARNING, S9X_USAGE, "Unable to start render threads, drawing on the emulation thread.");
+
 	return (TRUE);
 }
 
 void S9xGraphicsDeinit (void)
 {
+	S9xDeinitRenderThreads();
+
 	if (GFX.X2)         { free(GFX.X2);         GFX.X2         = NULL; }
 	if (GFX.ZERO)       { free(GFX.ZERO);       GFX.ZERO       = NULL; }
 	if (GFX.SubScreen)  { free(GFX.SubScreen);  GFX.SubScreen  = NULL; }
@@ -380,6 +456,9 @@ void S9xStartScreenRefresh (void)
 				IPPU.RenderedScreenHeight = PPU.ScreenHeight;
 			}
 
+			// Interlaced frames are drawn a field at a time, so lines never repeat.
+			LineSkip.Enabled = Settings.SkipUnchangedLines && !IPPU.DoubleHeightPixels && !GFX.DoInterlace;
+
 			IPPU.RenderedFramesCount++;
 		}
 
@@ -396,6 +475,13 @@ void S9xStartScreenRefresh (void)
 		IPPU.DisplayedRenderedFrameCount = IPPU.RenderedFramesCount;
 		IPPU.RenderedFramesCount = 0;
 		IPPU.FrameCount = 0;
+
+		uint32	drawn   = LineSkip.Drawn   - LineSkip.MarkDrawn;
+		uint32	skipped = LineSkip.Skipped - LineSkip.MarkSkipped;
+
+		LineSkip.Percent = (drawn + skipped) ? skipped * 100 / (drawn + skipped) : 0;
+		LineSkip.MarkDrawn   = LineSkip.Drawn;
+		LineSkip.MarkSkipped = LineSkip.Skipped;
 	}
 
 	if (GFX.InfoStringTimeout > 0 && --GFX.InfoStringTimeout == 0)
@@ -409,11 +495,15 @@ void S9xEndScreenRefresh (void)
 	if (IPPU.RenderThisFrame)
 	{
 		FLUSH_REDRAW();
+		S9xSyncRenderThreads();
 
 		if (GFX.DoInterlace && GFX.InterlaceFrame == 0)
 		{
 			S9xControlEOF();
+
+			PROFILE_BEGIN(PROF_PRESENT);
 			S9xContinueUpdate(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+			PROFILE_END();
 		}
 		else
 		{
@@ -433,7 +523,15 @@ void S9xEndScreenRefresh (void)
 			if (Settings.AutoDisplayMessages)
 				S9xDisplayMessages(GFX.Screen, GFX.RealPPL, IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight, 1);
 #endif // BeagleSNES
+			if (Settings.DisplayFrameRate)
+				DisplayFrameRate();
+
+			if (Settings.DisplayProfiler)
+				DisplayProfiler();
+
+			PROFILE_BEGIN(PROF_PRESENT);
 			S9xDeinitUpdate(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+			PROFILE_END();
 		}
 	}
 	else
@@ -485,6 +583,8 @@ void S9xEndScreenRefresh (void)
 
 void RenderLine (uint8 C)
 {
+	PROFILE_BEGIN(PROF_RENDER);
+
 	if (IPPU.RenderThisFrame)
 	{
 		LineData[C].BG[0].VOffset = PPU.BG[0].VOffset + 1;
@@ -522,6 +622,8 @@ void RenderLine (uint8 C)
 			SetupOBJ();
 		PPU.RangeTimeOver |= GFX.OBJLines[C].RTOFlags;
 	}
+
+	PROFILE_END();
 }
 
 static inline void RenderScreen (bool8 sub)
@@ -536,7 +638,7 @@ static inline void RenderScreen (bool8 sub)
 			GFX.S += GFX.RealPPL;
 		GFX.DB = GFX.ZBuffer;
 		GFX.Clip = IPPU.Clip[0];
-		BGActive = Memory.FillRAM[0x212c] & ~Settings.BG_Forced;
+		BGActive = GFX.FillRAM[0x212c] & ~Settings.BG_Forced;
 		D = 32;
 	}
 	else
@@ -544,15 +646,15 @@ static inline void RenderScreen (bool8 sub)
 		GFX.S = GFX.SubScreen;
 		GFX.DB = GFX.SubZBuffer;
 		GFX.Clip = IPPU.Clip[1];
-		BGActive = Memory.FillRAM[0x212d] & ~Settings.BG_Forced;
-		D = (Memory.FillRAM[0x2130] & 2) << 4; // 'do math' depth flag
+		BGActive = GFX.FillRAM[0x212d] & ~Settings.BG_Forced;
+		D = (GFX.FillRAM[0x2130] & 2) << 4; // 'do math' depth flag
 	}
 
 	if (BGActive & 0x10)
 	{
 		BG.TileAddress = PPU.OBJNameBase;
 		BG.NameSelect = PPU.OBJNameSelect;
-		BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 0x10);
+		BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 0x10);
 		BG.StartPalette = 128;
 		S9xSelectTileConverter(4, FALSE, sub, FALSE);
 		S9xSelectTileRenderers(PPU.BGMode, sub, TRUE);
@@ -566,7 +668,7 @@ static inline void RenderScreen (bool8 sub)
 		if (BGActive & (1 << n)) \
 		{ \
 			BG.StartPalette = pal; \
-			BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & (1 << n)); \
+			BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & (1 << n)); \
 			BG.TileSizeH = (!hires && PPU.BG[n].BGSize) ? 16 : 8; \
 			BG.TileSizeV = (PPU.BG[n].BGSize) ? 16 : 8; \
 			S9xSelectTileConverter(depth, hires, sub, PPU.BGMosaic[n]); \
@@ -632,13 +734,13 @@ static inline void RenderScreen (bool8 sub)
 		case 7:
 			if (BGActive & 0x01)
 			{
-				BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 1);
+				BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 1);
 				DrawBackgroundMode7(0, GFX.DrawMode7BG1Math, GFX.DrawMode7BG1Nomath, D);
 			}
 
-			if ((Memory.FillRAM[0x2133] & 0x40) && (BGActive & 0x02))
+			if ((GFX.FillRAM[0x2133] & 0x40) && (BGActive & 0x02))
 			{
-				BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 2);
+				BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 2);
 				DrawBackgroundMode7(1, GFX.DrawMode7BG2Math, GFX.DrawMode7BG2Nomath, D);
 			}
 
@@ -647,13 +749,15 @@ static inline void RenderScreen (bool8 sub)
 
 	#undef DO_BG
 
-	BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 0x20);
+	BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 0x20);
 
 	DrawBackdrop();
 }
 
 void S9xUpdateScreen (void)
 {
+	PROFILE_BEGIN(PROF_RENDER);
+
 	if (IPPU.OBJChanged || IPPU.InterlaceOBJ)
 		SetupOBJ();
 
@@ -679,6 +783,9 @@ void S9xUpdateScreen (void)
 		{
 			if (!IPPU.DoubleWidthPixels && (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires))
 			{
+				// The lines already drawn are about to be rewritten
+				S9xSyncRenderThreads();
+
 			#ifdef USE_OPENGL
 				if (Settings.OpenGLEnable && GFX.RealPPL == 256)
 				{
@@ -714,10 +821,15 @@ void S9xUpdateScreen (void)
 
 				IPPU.DoubleWidthPixels = TRUE;
 				IPPU.RenderedScreenWidth = 512;
+
+				LineSkip.Enabled = FALSE;
+				S9xInvalidateLines(0, SNES_HEIGHT_EXTENDED - 1);
 			}
 
 			if (!IPPU.DoubleHeightPixels && IPPU.Interlace && (PPU.BGMode == 5 || PPU.BGMode == 6))
 			{
+				S9xSyncRenderThreads();
+
 				IPPU.DoubleHeightPixels = TRUE;
 				IPPU.RenderedScreenHeight = PPU.ScreenHeight << 1;
 				GFX.PPL = GFX.RealPPL << 1;
@@ -725,14 +837,253 @@ void S9xUpdateScreen (void)
 
 				for (register int32 y = (int32) GFX.StartY - 1; y >= 0; y--)
 					memmove(GFX.Screen + y * GFX.PPL, GFX.Screen + y * GFX.RealPPL, IPPU.RenderedScreenWidth * sizeof(uint16));
+
+				LineSkip.Enabled = FALSE;
+				S9xInvalidateLines(0, SNES_HEIGHT_EXTENDED - 1);
 			}
 		}
 
 		if ((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2131] & 0x3f))
 			GFX.FixedColour = BUILD_PIXEL(IPPU.XB[PPU.FixedColourRed], IPPU.XB[PPU.FixedColourGreen], IPPU.XB[PPU.FixedColourBlue]);
+	}
 
+	if (LineSkip.Enabled)
+		DrawChangedLines();
+	else
+	{
+		DrawLines();
+
+		if (Settings.SkipUnchangedLines)
+			S9xInvalidateLines(GFX.StartY, GFX.EndY);
+	}
+
+	VRAMDirty.Epoch++;
+
+	IPPU.PreviousLine = IPPU.CurrentLine;
+
+	PROFILE_END();
+}
+
+static void DrawLines (void)
+{
+	if (S9xRenderThreadsRunning())
+		S9xQueueRenderLines();
+	else
+		S9xRenderLines();
+}
+
+static void DrawChangedLines (void)
+{
+	// Draw GFX.StartY to GFX.EndY as runs of lines whose signature changed.
+
+	uint32	first = GFX.StartY, last = GFX.EndY;
+	uint64	frame = LineSkipFrameHash();
+	int32	run = -1;
+
+	for (uint32 y = first; y <= last; y++)
+	{
+		uint64	h = LineSkipLineHash(frame, y);
+
+		if (LineSkip.Valid[y] && LineSkip.Hash[y] == h)
+		{
+			LineSkip.Skipped++;
+
+			if (run >= 0)
+			{
+				GFX.StartY = run;
+				GFX.EndY = y - 1;
+				DrawLines();
+				run = -1;
+			}
+		}
+		else
+		{
+			LineSkip.Hash[y] = h;
+			LineSkip.Valid[y] = TRUE;
+			LineSkip.Drawn++;
+
+			if (run < 0)
+				run = y;
+		}
+	}
+
+	if (run >= 0)
+	{
+		GFX.StartY = run;
+		GFX.EndY = last;
+		DrawLines();
+	}
+
+	GFX.StartY = first;
+	GFX.EndY = last;
+}
+
+static uint64 LineSkipFrameHash (void)
+{
+	// Everything that holds for the whole run of lines being drawn.
+
+	uint64	h = 0xcbf29ce484222325ULL;
+
+	LINE_HASH(h, (uint64) (pint) GFX.Screen);
+	LINE_HASH(h, (uint64) (pint) GFX.Screen >> 32);
+	LINE_HASH(h, GFX.PPL | (GFX.RealPPL << 16));
+	LINE_HASH(h, IPPU.RenderedScreenWidth | (IPPU.DoubleWidthPixels << 16) | (IPPU.PseudoHires << 20) | (IPPU.InterlaceOBJ << 24));
+	LINE_HASH(h, PPU.ForcedBlanking | (PPU.Brightness << 8) | (PPU.BGMode << 16) | (PPU.BG3Priority << 24));
+	LINE_HASH(h, Settings.BG_Forced | (Settings.Transparency << 8) | (Settings.SupportHiRes << 16));
+	LINE_HASH(h, GFX.FillRAM[0x212c] | (GFX.FillRAM[0x212d] << 8) | (GFX.FillRAM[0x2130] << 16) | (GFX.FillRAM[0x2131] << 24));
+	LINE_HASH(h, GFX.FillRAM[0x2133] | (PPU.ScreenHeight << 16));
+	LINE_HASH(h, GFX.FixedColour);
+	LINE_HASH(h, IPPU.CGRAMGeneration);
+
+	for (int bg = 0; bg < 4; bg++)
+	{
+		LINE_HASH(h, PPU.BG[bg].SCBase | (PPU.BG[bg].NameBase << 16));
+		LINE_HASH(h, PPU.BG[bg].BGSize | (PPU.BG[bg].SCSize << 8) | (PPU.BGMosaic[bg] << 16));
+	}
+
+	LINE_HASH(h, PPU.Mosaic | (PPU.MosaicStart << 8) | (PPU.Mode7HFlip << 16) | (PPU.Mode7VFlip << 17) | (PPU.Mode7Repeat << 24));
+	LINE_HASH(h, PPU.OBJNameBase | (PPU.OBJNameSelect << 16));
+	LINE_HASH(h, PPU.OBJSizeSelect);
+
+	for (int c = 0; c < 2; c++)
+	{
+		for (int w = 0; w < 6; w++)
+		{
+			struct ClipData	*clip = &IPPU.Clip[c][w];
+
+			LINE_HASH(h, clip->Count);
+			for (int i = 0; i < clip->Count; i++)
+				LINE_HASH(h, clip->DrawMode[i] | (clip->Left[i] << 8) | (clip->Right[i] << 20));
+		}
+	}
+
+	LINE_HASH(h, LineSkipVRAMStamp());
+
+	return (h);
+}
+
+static uint64 LineSkipLineHash (uint64 h, uint32 line)
+{
+	// What can differ from one line of the run to the next.
+
+	for (int bg = 0; bg < 4; bg++)
+		LINE_HASH(h, LineData[line].BG[bg].VOffset | (LineData[line].BG[bg].HOffset << 16));
+
+	if (PPU.BGMode == 7)
+	{
+		struct SLineMatrixData	*m = &LineMatrixData[line];
+
+		LINE_HASH(h, (uint16) m->MatrixA | ((uint16) m->MatrixB << 16));
+		LINE_HASH(h, (uint16) m->MatrixC | ((uint16) m->MatrixD << 16));
+		LINE_HASH(h, (uint16) m->CentreX | ((uint16) m->CentreY << 16));
+		LINE_HASH(h, (uint16) m->M7HOFS  | ((uint16) m->M7VOFS << 16));
+	}
+
+	LINE_HASH(h, GFX.OBJLines[line].RTOFlags | (GFX.OBJLines[line].Tiles << 8));
+
+	for (int i = 0; i < 32 && GFX.OBJLines[line].OBJ[i].Sprite >= 0; i++)
+	{
+		int				S = GFX.OBJLines[line].OBJ[i].Sprite;
+		struct SOBJ		*o = &PPU.OBJ[S];
+
+		LINE_HASH(h, S | (GFX.OBJLines[line].OBJ[i].Line << 8) | ((uint16) o->HPos << 16));
+		LINE_HASH(h, o->Name | (o->Palette << 16) | (o->Priority << 20) | (o->HFlip << 24) | (o->VFlip << 25));
+		LINE_HASH(h, GFX.OBJWidths[S] | (GFX.OBJVisibleTiles[S] << 8));
+	}
+
+	return (h);
+}
+
+static uint32 VRAMStampRange (uint32 address, uint32 bytes)
+{
+	uint32	stamp = 0;
+	uint32	page  = (address & 0xffff) >> VRAM_STAMP_SHIFT;
+	uint32	count = (bytes + (1 << VRAM_STAMP_SHIFT) - 1) >> VRAM_STAMP_SHIFT;
+
+	if (count > VRAM_STAMP_PAGES)
+		count = VRAM_STAMP_PAGES;
+
+	for (uint32 i = 0; i < count; i++)
+	{
+		uint32	s = VRAMDirty.Stamp[(page + i) & (VRAM_STAMP_PAGES - 1)];
+		if (s > stamp)
+			stamp = s;
+	}
+
+	return (stamp);
+}
+
+static uint32 LineSkipVRAMStamp (void)
+{
+	// Most recent write to any VRAM the current mode can read: each BG's
+	// tilemap and characters, and both sprite name tables.
+
+	static const uint8	depths[8][4] =
+	{
+		{ 2, 2, 2, 2 },
+		{ 4, 4, 2, 0 },
+		{ 4, 4, 0, 0 },
+		{ 8, 4, 0, 0 },
+		{ 8, 2, 0, 0 },
+		{ 4, 2, 0, 0 },
+		{ 4, 0, 0, 0 },
+		{ 0, 0, 0, 0 }
+	};
+
+	uint32	stamp = VRAMStampRange(PPU.OBJNameBase, 0x4000 + PPU.OBJNameSelect), s;
+
+	if (PPU.BGMode == 7)
+	{
+		s = VRAMStampRange(0, 0x8000);
+		return (s > stamp ? s : stamp);
+	}
+
+	for (int bg = 0; bg < 4; bg++)
+	{
+		// Modes 2, 4 and 6 read per-tile offsets from the BG3 tilemap.
+		bool8	opt = (bg == 2 && (PPU.BGMode == 2 || PPU.BGMode == 4 || PPU.BGMode == 6));
+
+		if (!depths[PPU.BGMode][bg] && !opt)
+			continue;
+
+		s = VRAMStampRange(PPU.BG[bg].SCBase << 1, 0x800 << ((PPU.BG[bg].SCSize & 1) + (PPU.BG[bg].SCSize >> 1)));
+		if (s > stamp)
+			stamp = s;
+
+		s = VRAMStampRange(PPU.BG[bg].NameBase << 1, depths[PPU.BGMode][bg] << 13);
+		if (s > stamp)
+			stamp = s;
+	}
+
+	return (stamp);
+}
+
+void S9xInvalidateLines (int first, int last)
+{
+	if (first < 0)
+		first = 0;
+	if (last >= SNES_HEIGHT_EXTENDED)
+		last = SNES_HEIGHT_EXTENDED - 1;
+
+	for (int y = first; y <= last; y++)
+		LineSkip.Valid[y] = FALSE;
+}
+
+void S9xGetLineSkipStats (uint32 *drawn, uint32 *skipped)
+{
+	*drawn   = LineSkip.Drawn;
+	*skipped = LineSkip.Skipped;
+}
+
+void S9xRenderLines (void)
+{
+	// Draws GFX.StartY to GFX.EndY from the current PPU state. Runs on the
+	// emulation thread, or on a render thread after it has installed a packet.
+
+	if (!PPU.ForcedBlanking)
+	{
 		if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires ||
-			((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2130] & 2) && (Memory.FillRAM[0x2131] & 0x3f) && (Memory.FillRAM[0x212d] & 0x1f)))
+			((GFX.FillRAM[0x2130] & 0x30) != 0x30 && (GFX.FillRAM[0x2130] & 2) && (GFX.FillRAM[0x2131] & 0x3f) && (GFX.FillRAM[0x212d] & 0x1f)))
 			// If hires (Mode 5/6 or pseudo-hires) or math is to be done
 			// involving the subscreen, then we need to render the subscreen...
 			RenderScreen(TRUE);
@@ -751,8 +1102,123 @@ void S9xUpdateScreen (void)
 			for (int x = 0; x < IPPU.RenderedScreenWidth; x++)
 				GFX.S[x] = black;
 	}
+}
 
-	IPPU.PreviousLine = IPPU.CurrentLine;
+static void BinOBJ (int S, int Width, int Height)
+{
+	// Moves one sprite from the lines it covered to the lines it covers now,
+	// marking both sets for BuildOBJLine. A sprite that only moved sideways
+	// without changing its tile count leaves every list as it was.
+
+	uint8	Y = (uint8) (PPU.OBJ[S].VPos & 0xff), Lines = 0, Tiles = GFX.OBJVisibleTiles[S];
+	// Yes, Width not Height. It so happens that the
+	// sprites with H=2*W flip as two WxW sprites.
+	uint8	Flip = PPU.OBJ[S].VFlip ? Width - 1 : 0;
+
+	int	HPos = PPU.OBJ[S].HPos;
+	if (HPos == -256)
+		HPos = OBJSetup.Rotation ? 256 : 0;
+
+	if (HPos > -Width && HPos <= 256)
+	{
+		if (HPos < 0)
+			Tiles = (Width + HPos + 7) >> 3;
+		else
+		if (HPos + Width > (OBJSetup.Rotation ? 256 : 255))
+			Tiles = ((OBJSetup.Rotation ? 257 : 256) - HPos + 7) >> 3;
+		else
+			Tiles = Width >> 3;
+
+		Lines = (Height - OBJSetup.StartLine + OBJSetup.Inc - 1) / OBJSetup.Inc;
+	}
+
+	GFX.OBJWidths[S] = Width;
+
+	if (Lines == OBJSetup.Lines[S] && (!Lines || (Y == OBJSetup.Y[S] && Flip == OBJSetup.Flip[S] && Tiles == GFX.OBJVisibleTiles[S])))
+		return;
+
+	uint32	bit = 1 << (S & 31);
+	uint32	*OnLine = &OBJSetup.OnLine[0][S >> 5];
+
+	for (int k = 0; k < OBJSetup.Lines[S]; k++)
+	{
+		uint8	l = OBJSetup.Y[S] + k;
+		if (l < SNES_HEIGHT_EXTENDED)
+		{
+			OnLine[l * 4] &= ~bit;
+			OBJSetup.LineDirty[l] = TRUE;
+		}
+	}
+
+	GFX.OBJVisibleTiles[S] = Tiles;
+	OBJSetup.Y[S] = Y;
+	OBJSetup.Lines[S] = Lines;
+	OBJSetup.Flip[S] = Flip;
+
+	for (int k = 0; k < Lines; k++)
+	{
+		uint8	l = Y + k;
+		if (l < SNES_HEIGHT_EXTENDED)
+		{
+			OnLine[l * 4] |= bit;
+			OBJSetup.LineDirty[l] = TRUE;
+		}
+	}
+
+	OBJSetup.Rebinned++;
+}
+
+static void BuildOBJLine (int Y)
+{
+	// Lists the sprites on line Y in priority order, starting from FirstSprite
+	// (or FirstSprite+Y), and applies the 32 sprite and 34 tile limits.
+
+	uint8	FirstSprite = OBJSetup.Rotation ? (PPU.FirstSprite + Y) & 0x7f : PPU.FirstSprite;
+	uint8	RTOFlags = 0;
+	int16	Tiles = 34;
+	int		j = 0;
+
+	for (int w = 0; w <= 4; w++)
+	{
+		int		word = ((FirstSprite >> 5) + w) & 3;
+		uint32	m = OBJSetup.OnLine[Y][word];
+
+		// The word holding FirstSprite is split: its upper part goes first,
+		// its lower part last.
+		if (w == 0)
+			m &= ~0U << (FirstSprite & 31);
+		else
+		if (w == 4)
+			m &= ~(~0U << (FirstSprite & 31));
+
+		for (; m; m &= m - 1)
+		{
+			if (j >= 32)
+			{
+				RTOFlags |= 0x40;
+				w = 4;
+				break;
+			}
+
+			int	S = (word << 5) + OBJ_LOWEST_BIT(m);
+
+			Tiles -= GFX.OBJVisibleTiles[S];
+			if (Tiles < 0)
+				RTOFlags |= 0x80;
+
+			GFX.OBJLines[Y].OBJ[j].Sprite = S;
+			GFX.OBJLines[Y].OBJ[j].Line = (OBJSetup.StartLine + (uint8) (Y - OBJSetup.Y[S]) * OBJSetup.Inc) ^ OBJSetup.Flip[S];
+			j++;
+		}
+	}
+
+	if (j < 32)
+		GFX.OBJLines[Y].OBJ[j].Sprite = -1;
+
+	GFX.OBJLines[Y].Tiles = Tiles;
+	OBJSetup.RTOFlags[Y] = RTOFlags;
+	OBJSetup.LineDirty[Y] = FALSE;
+	OBJSetup.LinesBuilt++;
 }
 
 static void SetupOBJ (void)
@@ -803,180 +1269,83 @@ static void SetupOBJ (void)
 			break;
 	}
 
-	int	inc = IPPU.InterlaceOBJ ? 2 : 1;
+	uint8	Inc = IPPU.InterlaceOBJ ? 2 : 1;
+	uint8	StartLine = (IPPU.InterlaceOBJ && GFX.InterlaceFrame) ? 1 : 0;
 
-	int startline = (IPPU.InterlaceOBJ && GFX.InterlaceFrame) ? 1 : 0;
+	// We have three cases here. Either there's no priority, priority is
+	// normal FirstSprite, or priority is FirstSprite+Y. In the last case a
+	// sprite at X=-256 counts as X=256 against the time limit, so changing
+	// between the cases rebins every sprite.
+	bool8	Rotation = PPU.OAMPriorityRotation && (PPU.OAMFlip & PPU.OAMAddr & 1);
 
-	// OK, we have three cases here. Either there's no priority, priority is
-	// normal FirstSprite, or priority is FirstSprite+Y. The first two are
-	// easy, the last is somewhat more ... interesting. So we split them up.
+	OBJSetup.Calls++;
 
-	int		Height;
-	uint8	S;
+	if (!OBJSetup.Valid || OBJSetup.SizeSelect != PPU.OBJSizeSelect || OBJSetup.Inc != Inc || OBJSetup.Rotation != Rotation)
+	{
+		OBJSetup.Valid = TRUE;
+		OBJSetup.SizeSelect = PPU.OBJSizeSelect;
+		OBJSetup.Inc = Inc;
+		OBJSetup.Rotation = Rotation;
+		ZeroMemory(OBJSetup.Lines, sizeof(OBJSetup.Lines));
+		ZeroMemory(OBJSetup.OnLine, sizeof(OBJSetup.OnLine));
+		memset(IPPU.OBJDirty, 0xff, sizeof(IPPU.OBJDirty));
+		memset(OBJSetup.LineDirty, TRUE, sizeof(OBJSetup.LineDirty));
+		OBJSetup.Full++;
+	}
 
-	if (!PPU.OAMPriorityRotation || !(PPU.OAMFlip & PPU.OAMAddr & 1)) // normal case
+	// Sprites keep their lines when only the order or the interlace field
+	// changes, but every list has to be redone.
+	if (OBJSetup.FirstSprite != PPU.FirstSprite || OBJSetup.StartLine != StartLine)
 	{
-		uint8	LineOBJ[SNES_HEIGHT_EXTENDED];
-		ZeroMemory(LineOBJ, sizeof(LineOBJ));
+		OBJSetup.FirstSprite = PPU.FirstSprite;
+		OBJSetup.StartLine = StartLine;
+		memset(OBJSetup.LineDirty, TRUE, sizeof(OBJSetup.LineDirty));
+	}
 
-		for (int i = 0; i < SNES_HEIGHT_EXTENDED; i++)
+	for (int w = 0; w < 4; w++)
+	{
+		for (uint32 m = IPPU.OBJDirty[w]; m; m &= m - 1)
 		{
-			GFX.OBJLines[i].RTOFlags = 0;
-			GFX.OBJLines[i].Tiles = 34;
-			for (int j = 0; j < 32; j++)
-				GFX.OBJLines[i].OBJ[j].Sprite = -1;
-		}
-
-		uint8	FirstSprite = PPU.FirstSprite;
-		S = FirstSprite;
+			int	S = (w << 5) + OBJ_LOWEST_BIT(m);
 
-		do
-		{
 			if (PPU.OBJ[S].Size)
-			{
-				GFX.OBJWidths[S] = LargeWidth;
-				Height = LargeHeight;
-			}
+				BinOBJ(S, LargeWidth, LargeHeight);
 			else
-			{
-				GFX.OBJWidths[S] = SmallWidth;
-				Height = SmallHeight;
-			}
-
-			int	HPos = PPU.OBJ[S].HPos;
-			if (HPos == -256)
-				HPos = 0;
-
-			if (HPos > -GFX.OBJWidths[S] && HPos <= 256)
-			{
-				if (HPos < 0)
-					GFX.OBJVisibleTiles[S] = (GFX.OBJWidths[S] + HPos + 7) >> 3;
-				else
-				if (HPos + GFX.OBJWidths[S] > 255)
-					GFX.OBJVisibleTiles[S] = (256 - HPos + 7) >> 3;
-				else
-					GFX.OBJVisibleTiles[S] = GFX.OBJWidths[S] >> 3;
-
-				for (uint8 line = startline, Y = (uint8) (PPU.OBJ[S].VPos & 0xff); line < Height; Y++, line += inc)
-				{
-					if (Y >= SNES_HEIGHT_EXTENDED)
-						continue;
-
-					if (LineOBJ[Y] >= 32)
-					{
-						GFX.OBJLines[Y].RTOFlags |= 0x40;
-						continue;
-					}
-
-					GFX.OBJLines[Y].Tiles -= GFX.OBJVisibleTiles[S];
-					if (GFX.OBJLines[Y].Tiles < 0)
-						GFX.OBJLines[Y].RTOFlags |= 0x80;
-
-					GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Sprite = S;
-					if (PPU.OBJ[S].VFlip)
-						// Yes, Width not Height. It so happens that the
-						// sprites with H=2*W flip as two WxW sprites.
-						GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line ^ (GFX.OBJWidths[S] - 1);
-					else
-						GFX.OBJLines[Y].OBJ[LineOBJ[Y]].Line = line;
+				BinOBJ(S, SmallWidth, SmallHeight);
+		}
 
-					LineOBJ[Y]++;
-				}
-			}
+		IPPU.OBJDirty[w] = 0;
+	}
 
-			S = (S + 1) & 0x7f;
-		} while (S != FirstSprite);
+	bool8	rebuilt = FALSE;
 
-		for (int Y = 1; Y < SNES_HEIGHT_EXTENDED; Y++)
-			GFX.OBJLines[Y].RTOFlags |= GFX.OBJLines[Y - 1].RTOFlags;
-	}
-	else // evil FirstSprite+Y case
+	for (int Y = 0; Y < SNES_HEIGHT_EXTENDED; Y++)
 	{
-		// First, find out which sprites are on which lines
-		uint8	OBJOnLine[SNES_HEIGHT_EXTENDED][128];
-		ZeroMemory(OBJOnLine, sizeof(OBJOnLine));
-
-		for (S = 0; S < 128; S++)
+		if (OBJSetup.LineDirty[Y])
 		{
-			if (PPU.OBJ[S].Size)
-			{
-				GFX.OBJWidths[S] = LargeWidth;
-				Height = LargeHeight;
-			}
-			else
-			{
-				GFX.OBJWidths[S] = SmallWidth;
-				Height = SmallHeight;
-			}
-
-			int	HPos = PPU.OBJ[S].HPos;
-			if (HPos == -256)
-				HPos = 256;
-
-			if (HPos > -GFX.OBJWidths[S] && HPos <= 256)
-			{
-				if (HPos < 0)
-					GFX.OBJVisibleTiles[S] = (GFX.OBJWidths[S] + HPos + 7) >> 3;
-				else
-				if (HPos + GFX.OBJWidths[S] >= 257)
-					GFX.OBJVisibleTiles[S] = (257 - HPos + 7) >> 3;
-				else
-					GFX.OBJVisibleTiles[S] = GFX.OBJWidths[S] >> 3;
-
-				for (uint8 line = startline, Y = (uint8) (PPU.OBJ[S].VPos & 0xff); line < Height; Y++, line += inc)
-				{
-					if (Y >= SNES_HEIGHT_EXTENDED)
-						continue;
-
-					if (PPU.OBJ[S].VFlip)
-						// Yes, Width not Height. It so happens that the
-						// sprites with H=2*W flip as two WxW sprites.
-						OBJOnLine[Y][S] = (line ^ (GFX.OBJWidths[S] - 1)) | 0x80;
-					else
-						OBJOnLine[Y][S] = line | 0x80;
-				}
-			}
+			BuildOBJLine(Y);
+			rebuilt = TRUE;
 		}
+	}
 
-		// Now go through and pull out those OBJ that are actually visible.
-		int	j;
-		for (int Y = 0; Y < SNES_HEIGHT_EXTENDED; Y++)
-		{
-			GFX.OBJLines[Y].RTOFlags = Y ? GFX.OBJLines[Y - 1].RTOFlags : 0;
-			GFX.OBJLines[Y].Tiles = 34;
-
-			uint8	FirstSprite = (PPU.FirstSprite + Y) & 0x7f;
-			S = FirstSprite;
-			j = 0;
-
-			do
-			{
-				if (OBJOnLine[Y][S])
-				{
-					if (j >= 32)
-					{
-						GFX.OBJLines[Y].RTOFlags |= 0x40;
-						break;
-					}
-
-					GFX.OBJLines[Y].Tiles -= GFX.OBJVisibleTiles[S];
-					if (GFX.OBJLines[Y].Tiles < 0)
-						GFX.OBJLines[Y].RTOFlags |= 0x80;
-					GFX.OBJLines[Y].OBJ[j].Sprite = S;
-					GFX.OBJLines[Y].OBJ[j++].Line = OBJOnLine[Y][S] & ~0x80;
-				}
-
-				S = (S + 1) & 0x7f;
-			} while (S != FirstSprite);
-
-			if (j < 32)
-				GFX.OBJLines[Y].OBJ[j].Sprite = -1;
-		}
+	if (rebuilt)
+	{
+		GFX.OBJLines[0].RTOFlags = OBJSetup.RTOFlags[0];
+		for (int Y = 1; Y < SNES_HEIGHT_EXTENDED; Y++)
+			GFX.OBJLines[Y].RTOFlags = OBJSetup.RTOFlags[Y] | GFX.OBJLines[Y - 1].RTOFlags;
 	}
 
 	IPPU.OBJChanged = FALSE;
 }
 
+void S9xGetOBJSetupStats (uint32 *calls, uint32 *full, uint32 *rebinned, uint32 *lines)
+{
+	*calls    = OBJSetup.Calls;
+	*full     = OBJSetup.Full;
+	*rebinned = OBJSetup.Rebinned;
+	*lines    = OBJSetup.LinesBuilt;
+}
+
 static void DrawOBJS (int D)
 {
 	void (*DrawTile) (uint32, uint32, uint32, uint32) = NULL;
@@ -1077,15 +1446,15 @@ static void DrawBackground (int bg, uint8 Zh, uint8 Zl)
 	uint32	Tile;
 	uint16	*SC0, *SC1, *SC2, *SC3;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	uint32	Lines;
@@ -1294,15 +1663,15 @@ static void DrawBackgroundMosaic (int bg, uint8 Zh, uint8 Zl)
 	uint32	Tile;
 	uint16	*SC0, *SC1, *SC2, *SC3;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	Lines;
@@ -1461,26 +1830,26 @@ static void DrawBackgroundOffset (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 	uint16	*SC0, *SC1, *SC2, *SC3;
 	uint16	*BPS0, *BPS1, *BPS2, *BPS3;
 
-	BPS0 = (uint16 *) &Memory.VRAM[PPU.BG[2].SCBase << 1];
+	BPS0 = (uint16 *) &GFX.VRAM[PPU.BG[2].SCBase << 1];
 	BPS1 = (PPU.BG[2].SCSize & 1) ? BPS0 + 1024 : BPS0;
-	if (BPS1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS1 -= 0x8000;
 	BPS2 = (PPU.BG[2].SCSize & 2) ? BPS1 + 1024 : BPS0;
-	if (BPS2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS2 -= 0x8000;
 	BPS3 = (PPU.BG[2].SCSize & 1) ? BPS2 + 1024 : BPS2;
-	if (BPS3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS3 -= 0x8000;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	OffsetMask   = (BG.TileSizeH   == 16) ? 0x3ff : 0x1ff;
@@ -1692,26 +2061,26 @@ static void DrawBackgroundOffsetMosaic (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 	uint16	*SC0, *SC1, *SC2, *SC3;
 	uint16	*BPS0, *BPS1, *BPS2, *BPS3;
 
-	BPS0 = (uint16 *) &Memory.VRAM[PPU.BG[2].SCBase << 1];
+	BPS0 = (uint16 *) &GFX.VRAM[PPU.BG[2].SCBase << 1];
 	BPS1 = (PPU.BG[2].SCSize & 1) ? BPS0 + 1024 : BPS0;
-	if (BPS1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS1 -= 0x8000;
 	BPS2 = (PPU.BG[2].SCSize & 2) ? BPS1 + 1024 : BPS0;
-	if (BPS2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS2 -= 0x8000;
 	BPS3 = (PPU.BG[2].SCSize & 1) ? BPS2 + 1024 : BPS2;
-	if (BPS3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS3 -= 0x8000;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	Lines;
@@ -1990,6 +2359,8 @@ static void DisplayStringFromBottom (const char *string, int linesFromBottom, in
 
 	uint16	*dst = GFX.Screen + (IPPU.RenderedScreenHeight - font_height * linesFromBottom) * GFX.RealPPL + pixelsFromLeft;
 
+	S9xInvalidateLines(IPPU.RenderedScreenHeight - font_height * linesFromBottom, IPPU.RenderedScreenHeight - 1);
+
 	int	len = strlen(string);
 	int	max_chars = IPPU.RenderedScreenWidth / (font_width - 1);
 	int	char_count = 0;
@@ -2043,6 +2414,92 @@ static void DisplayFrameRate (void)
 
 	S9xDisplayString(string, 1, IPPU.RenderedScreenWidth - (font_width - 1) * len - 1, false);
 }
+
+#define PROFILER_BAR_WIDTH	128		// pixels for one full frame budget
+#define PROFILER_BAR_HEIGHT	3
+
+static void DrawProfilerBar (const struct SProfilerFrame *f, int left, int top, int budget)
+{
+	static const uint8	colours[PROF_SECTIONS][3] =
+	{
+		{  0, 31,  0 },	// 65c816
+		{ 31, 31,  0 },	// APU
+		{  0, 16, 31 },	// Render
+		{ 31,  0, 31 },	// DMA/HDMA
+		{  0, 31, 31 },	// SA1
+		{ 31, 16,  0 },	// SuperFX
+		{ 16,  8, 31 },	// DSP
+		{ 31, 16, 16 },	// SPC7110
+		{ 16, 31, 16 },	// HEvent
+		{ 31,  0,  0 },	// Present
+		{ 12, 12, 12 },	// Sync
+		{ 20, 20, 20 }	// Other
+	};
+
+	const int	limit = PROFILER_BAR_WIDTH * 3 / 2;
+	uint32		elapsed = 0;
+	int			x = 0;
+
+	for (int i = 0; i < PROF_SECTIONS && x < limit; i++)
+	{
+		elapsed += f->Time[i];
+
+		int		end = elapsed * PROFILER_BAR_WIDTH / budget;
+		uint16	colour = BUILD_PIXEL(colours[i][0], colours[i][1], colours[i][2]);
+
+		if (end > limit)
+			end = limit;
+
+		for (; x < end; x++)
+			for (int y = 0; y < PROFILER_BAR_HEIGHT; y++)
+				GFX.Screen[(top + y) * GFX.RealPPL + left + x] = colour;
+	}
+
+	for (; x < limit; x++)
+		for (int y = 0; y < PROFILER_BAR_HEIGHT; y++)
+			GFX.Screen[(top + y) * GFX.RealPPL + left + x] = 0;
+
+	for (int y = -1; y <= PROFILER_BAR_HEIGHT; y++)
+		GFX.Screen[(top + y) * GFX.RealPPL + left + PROFILER_BAR_WIDTH] = Settings.DisplayColor;
+
+	S9xInvalidateLines(top - 1, top + PROFILER_BAR_HEIGHT);
+}
+
+static void DisplayProfiler (void)
+{
+	// Upper bar is the last frame, lower bar the slowest frame of the last second.
+	// Full width is 1.5 frames; the tick marks the frame budget.
+	const struct SProfilerFrame	*last = S9xProfilerGetFrame(0), *worst = last;
+
+	if (!last)
+		return;
+
+	for (int age = 1; age < (int) Memory.ROMFramesPerSecond; age++)
+	{
+		const struct SProfilerFrame	*f = S9xProfilerGetFrame(age);
+		if (!f)
+			break;
+
+		if (f->Total > worst->Total)
+			worst = f;
+	}
+
+	int	budget = Settings.FrameTime ? Settings.FrameTime : 16667;
+	int	left = IPPU.RenderedScreenWidth - PROFILER_BAR_WIDTH * 3 / 2 - 1;
+	int	top = IPPU.RenderedScreenHeight - font_height * 2 - (PROFILER_BAR_HEIGHT + 2) * 2;
+
+	DrawProfilerBar(last,  left, top, budget);
+	DrawProfilerBar(worst, left, top + PROFILER_BAR_HEIGHT + 2, budget);
+
+	if (Settings.SkipUnchangedLines)
+	{
+		// Share of lines reused from the previous frame over the last second.
+		char	string[16];
+
+		sprintf(string, "%u%% kept", LineSkip.Percent);
+		S9xDisplayString(string, 3, left - (font_width - 1) * strlen(string) - 4, false);
+	}
+}
 #if 0 // AWH - BeagleSNES
 static void DisplayPressedKeys (void)
 {
@@ -2365,6 +2822,7 @@ HIGH_BITS_SHIFTED_TWO_MASK = ((FIRST_COLOR_MASK | SECOND_COLOR_MASK | THIRD_COLO
 bool8 S9xSetRenderPixelFormat (int format)
 {
 	GFX.PixelFormat = format;
+	S9xInvalidateLines(0, SNES_HEIGHT_EXTENDED - 1);
 
 	switch (format)
 	{
@@ -185,6 +185,8 @@ struct SGFX
 	uint16	*SubScreen;
 	uint8	*ZBuffer;
 	uint8	*SubZBuffer;
+	uint8	*VRAM;				// VRAM and PPU registers the renderer reads;
+	uint8	*FillRAM;			// private copies on render threads
 	uint32	Pitch;
 	uint32	ScreenSize;
 	uint16	*S;
@@ -266,8 +268,10 @@ struct SBG
 	uint8	EnableMath;
 	uint8	InterlaceLine;
 
-	uint8	*Buffer;
-	uint8	*BufferFlip;
+	uint32	Format;
+	uint32	FormatFlip;
+	uint16	*Slot;
+	uint16	*SlotFlip;
 	uint8	*Buffered;
 	uint8	*BufferedFlip;
 	bool8	DirectColourMode;
@@ -295,10 +299,10 @@ struct SLineMatrixData
 };
 
 extern uint16		BlackColourMap[256];
-extern uint16		DirectColourMaps[8][256];
+extern S9X_THREAD_LOCAL uint16	DirectColourMaps[8][256];
 extern uint8		mul_brightness[16][32];
-extern struct SBG	BG;
-extern struct SGFX	GFX;
+extern S9X_THREAD_LOCAL struct SBG	BG;
+extern S9X_THREAD_LOCAL struct SGFX	GFX;
 
 #define H_FLIP		0x4000
 #define V_FLIP		0x8000
@@ -341,9 +345,14 @@ inline uint16 COLOR_SUB (uint16 C1, uint16 C2)
 void S9xStartScreenRefresh (void);
 void S9xEndScreenRefresh (void);
 void S9xUpdateScreen (void);
+void S9xRenderLines (void);
 void S9xBuildDirectColourMaps (void);
 void RenderLine (uint8);
 void S9xComputeClipWindows (void);
+void S9xGetClipCacheStats (uint32 *, uint32 *);
+void S9xInvalidateLines (int, int);
+void S9xGetLineSkipStats (uint32 *, uint32 *);
+void S9xGetOBJSetupStats (uint32 *, uint32 *, uint32 *, uint32 *);
 void S9xDisplayChar (uint16 *, uint8);
 // called automatically unless Settings.AutoDisplayMessages is false
 void S9xDisplayMessages (uint16 *, int, int, int, int);
@@ -0,0 +1,506 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#include <pthread.h>
+#include "snes9x.h"
+#include "memmap.h"
+#include "ppu.h"
+#include "gfxthread.h"
+#include "tile.h"
+
+// One packet per FLUSH_REDRAW, and there is at most one per line. When the
+// packets or the arena run out the emulation thread drains the queue first.
+#define RENDER_PACKETS			(SNES_HEIGHT_EXTENDED + 1)
+#define RENDER_ARENA_SIZE		(256 * 1024)
+
+struct SRenderPacket
+{
+	uint32	StartY;
+	uint32	EndY;
+	bool8	RebuildDirectColourMaps;
+	uint32	VRAMBlocks;			// changed VRAM blocks since the last packet
+	uint32	VRAMOffset;			// arena offset of the block numbers, then their data
+	uint32	OBJLinesOffset;		// arena offset of GFX.OBJLines[StartY..EndY]
+
+	struct SPPU	PPU;
+	struct ClipData	Clip[2][6];
+	uint16	ScreenColors[256];
+	uint8	*XB;
+	bool8	Interlace;
+	bool8	PseudoHires;
+	bool8	DoubleWidthPixels;
+	int		RenderedScreenWidth;
+
+	uint16	*Screen;
+	uint16	*SubScreen;
+	uint8	*ZBuffer;
+	uint8	*SubZBuffer;
+	uint16	*X2;
+	uint16	*ZERO;
+	uint32	RealPPL;
+	uint32	PPL;
+	uint32	FixedColour;
+	uint8	DoInterlace;
+	uint8	InterlaceFrame;
+	uint8	OBJWidths[128];
+	uint8	OBJVisibleTiles[128];
+#ifdef GFX_MULTI_FORMAT
+	uint32	PixelFormat;
+	uint32	(*BuildPixel) (uint32, uint32, uint32);
+	uint32	(*BuildPixel2) (uint32, uint32, uint32);
+	void	(*DecomposePixel) (uint32, uint32 &, uint32 &, uint32 &);
+#endif
+
+	uint8	FillRAM[0x100];		// $2100-$21FF
+};
+
+struct SRenderThread
+{
+	pthread_t	Thread;
+	uint32		First;			// band of lines this thread draws
+	uint32		Last;
+	uint32		Next;			// next packet to apply
+	uint8		*VRAM;
+	uint8		*FillRAM;
+	struct STileCache	TileCache;
+	uint8		*TileCached[7];
+};
+
+static struct
+{
+	int				Count;
+	bool8			Quit;
+	pthread_mutex_t	Lock;
+	pthread_cond_t	Work;
+	pthread_cond_t	Idle;
+	uint32			Queued;
+	uint32			ArenaUsed;
+	struct SRenderPacket	*Packet;
+	uint8			*Arena;
+	uint32			Packets;
+	uint32			Blocks;
+	struct SRenderThread	Thread[MAX_RENDER_THREADS];
+}	RT;
+
+static const uint32	TileCacheSize[7] =
+{
+	MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_8BIT_TILES, MAX_2BIT_TILES, MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_4BIT_TILES
+};
+
+static void * RenderThreadMain (void *);
+static void ApplyPacket (struct SRenderThread *, struct SRenderPacket *);
+static void InvalidateTiles (uint32);
+static void FreeRenderThread (struct SRenderThread *);
+static uint32 ArenaAlloc (uint32);
+
+
+bool8 S9xInitRenderThreads (int count)
+{
+#ifndef RENDER_THREADS
+	// The threads would all share one GFX and PPU
+	return (FALSE);
+#endif
+
+	S9xDeinitRenderThreads();
+
+	if (count > MAX_RENDER_THREADS)
+		count = MAX_RENDER_THREADS;
+	if (count < 1)
+		return (FALSE);
+
+	RT.Packet = (struct SRenderPacket *) malloc(RENDER_PACKETS * sizeof(struct SRenderPacket));
+	RT.Arena  = (uint8 *) malloc(RENDER_ARENA_SIZE);
+	if (!RT.Packet || !RT.Arena)
+	{
+		S9xDeinitRenderThreads();
+		return (FALSE);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		struct SRenderThread	*t = &RT.Thread[i];
+
+		memset(t, 0, sizeof(struct SRenderThread));
+		t->First = i * SNES_HEIGHT / count;
+		t->Last  = (i == count - 1) ? SNES_HEIGHT_EXTENDED - 1 : (i + 1) * SNES_HEIGHT / count - 1;
+		t->VRAM    = (uint8 *) calloc(0x10000, 1);
+		t->FillRAM = (uint8 *) calloc(0x2200, 1);
+
+		bool8	ok = t->VRAM && t->FillRAM && S9xInitTileCache(&t->TileCache, Settings.TileCacheSize);
+
+		for (int c = 0; c < 7; c++)
+		{
+			t->TileCached[c] = (uint8 *) calloc(TileCacheSize[c], 1);
+			ok = ok && t->TileCached[c];
+		}
+
+		if (!ok)
+		{
+			for (int j = 0; j <= i; j++)
+				FreeRenderThread(&RT.Thread[j]);
+			S9xDeinitRenderThreads();
+			return (FALSE);
+		}
+	}
+
+	pthread_mutex_init(&RT.Lock, NULL);
+	pthread_cond_init(&RT.Work, NULL);
+	pthread_cond_init(&RT.Idle, NULL);
+	RT.Quit = FALSE;
+	RT.Queued = 0;
+	RT.ArenaUsed = 0;
+	RT.Packets = 0;
+	RT.Blocks = 0;
+
+	// The threads start with zeroed VRAM, so the first packet carries all of it
+	S9xMarkAllVRAMDirty();
+
+	for (RT.Count = 0; RT.Count < count; RT.Count++)
+	{
+		if (pthread_create(&RT.Thread[RT.Count].Thread, NULL, RenderThreadMain, &RT.Thread[RT.Count]))
+		{
+			FreeRenderThread(&RT.Thread[RT.Count]);
+			for (int i = RT.Count + 1; i < count; i++)
+				FreeRenderThread(&RT.Thread[i]);
+			S9xDeinitRenderThreads();
+			return (FALSE);
+		}
+	}
+
+	return (TRUE);
+}
+
+void S9xDeinitRenderThreads (void)
+{
+	if (RT.Count)
+	{
+		S9xSyncRenderThreads();
+
+		pthread_mutex_lock(&RT.Lock);
+		RT.Quit = TRUE;
+		pthread_cond_broadcast(&RT.Work);
+		pthread_mutex_unlock(&RT.Lock);
+
+		for (int i = 0; i < RT.Count; i++)
+		{
+			pthread_join(RT.Thread[i].Thread, NULL);
+			FreeRenderThread(&RT.Thread[i]);
+		}
+
+		pthread_cond_destroy(&RT.Idle);
+		pthread_cond_destroy(&RT.Work);
+		pthread_mutex_destroy(&RT.Lock);
+		RT.Count = 0;
+
+		// Only the render threads kept their maps up to date
+		IPPU.DirectColourMapsNeedRebuild = TRUE;
+	}
+
+	if (RT.Packet) { free(RT.Packet); RT.Packet = NULL; }
+	if (RT.Arena)  { free(RT.Arena);  RT.Arena  = NULL; }
+}
+
+bool8 S9xRenderThreadsRunning (void)
+{
+	return (RT.Count != 0);
+}
+
+void S9xGetRenderThreadStats (uint32 *packets, uint32 *blocks)
+{
+	*packets = RT.Packets;
+	*blocks  = RT.Blocks;
+}
+
+void S9xMarkAllVRAMDirty (void)
+{
+	for (uint32 b = 0; b < VRAM_DIRTY_BLOCKS; b++)
+	{
+		VRAMDirty.Flag[b] = TRUE;
+		VRAMDirty.List[b] = b;
+	}
+
+	VRAMDirty.Count = VRAM_DIRTY_BLOCKS;
+
+	for (uint32 b = 0; b < VRAM_STAMP_PAGES; b++)
+		VRAMDirty.Stamp[b] = VRAMDirty.Epoch;
+}
+
+void S9xQueueRenderLines (void)
+{
+	if (GFX.StartY > GFX.EndY)
+		return;
+
+	uint32	lines = GFX.EndY - GFX.StartY + 1;
+	uint32	need = VRAMDirty.Count * (sizeof(uint16) + (1 << VRAM_DIRTY_SHIFT)) + lines * sizeof(GFX.OBJLines[0]) + 16;
+
+	if (RT.Queued == RENDER_PACKETS || RT.ArenaUsed + need > RENDER_ARENA_SIZE)
+		S9xSyncRenderThreads();
+
+	struct SRenderPacket	*p = &RT.Packet[RT.Queued];
+
+	p->StartY = GFX.StartY;
+	p->EndY   = GFX.EndY;
+	p->RebuildDirectColourMaps = IPPU.DirectColourMapsNeedRebuild;
+	IPPU.DirectColourMapsNeedRebuild = FALSE;
+
+	p->VRAMBlocks = VRAMDirty.Count;
+	p->VRAMOffset = ArenaAlloc(VRAMDirty.Count * (sizeof(uint16) + (1 << VRAM_DIRTY_SHIFT)));
+
+	uint16	*block = (uint16 *) (RT.Arena + p->VRAMOffset);
+	uint8	*data  = (uint8 *) (block + VRAMDirty.Count);
+
+	for (uint32 i = 0; i < VRAMDirty.Count; i++, data += 1 << VRAM_DIRTY_SHIFT)
+	{
+		uint32	b = VRAMDirty.List[i];
+
+		block[i] = b;
+		memcpy(data, Memory.VRAM + (b << VRAM_DIRTY_SHIFT), 1 << VRAM_DIRTY_SHIFT);
+		VRAMDirty.Flag[b] = FALSE;
+	}
+
+	RT.Blocks += VRAMDirty.Count;
+	VRAMDirty.Count = 0;
+
+	p->OBJLinesOffset = ArenaAlloc(lines * sizeof(GFX.OBJLines[0]));
+	memcpy(RT.Arena + p->OBJLinesOffset, &GFX.OBJLines[GFX.StartY], lines * sizeof(GFX.OBJLines[0]));
+
+	p->PPU = PPU;
+	memcpy(p->Clip, IPPU.Clip, sizeof(p->Clip));
+	memcpy(p->ScreenColors, IPPU.ScreenColors, sizeof(p->ScreenColors));
+	p->XB = IPPU.XB;
+	p->Interlace = IPPU.Interlace;
+	p->PseudoHires = IPPU.PseudoHires;
+	p->DoubleWidthPixels = IPPU.DoubleWidthPixels;
+	p->RenderedScreenWidth = IPPU.RenderedScreenWidth;
+
+	p->Screen = GFX.Screen;
+	p->SubScreen = GFX.SubScreen;
+	p->ZBuffer = GFX.ZBuffer;
+	p->SubZBuffer = GFX.SubZBuffer;
+	p->X2 = GFX.X2;
+	p->ZERO = GFX.ZERO;
+	p->RealPPL = GFX.RealPPL;
+	p->PPL = GFX.PPL;
+	p->FixedColour = GFX.FixedColour;
+	p->DoInterlace = GFX.DoInterlace;
+	p->InterlaceFrame = GFX.InterlaceFrame;
+	memcpy(p->OBJWidths, GFX.OBJWidths, sizeof(p->OBJWidths));
+	memcpy(p->OBJVisibleTiles, GFX.OBJVisibleTiles, sizeof(p->OBJVisibleTiles));
+#ifdef GFX_MULTI_FORMAT
+	p->PixelFormat = GFX.PixelFormat;
+	p->BuildPixel = GFX.BuildPixel;
+	p->BuildPixel2 = GFX.BuildPixel2;
+	p->DecomposePixel = GFX.DecomposePixel;
+#endif
+
+	memcpy(p->FillRAM, Memory.FillRAM + 0x2100, sizeof(p->FillRAM));
+
+	pthread_mutex_lock(&RT.Lock);
+	RT.Queued++;
+	RT.Packets++;
+	pthread_cond_broadcast(&RT.Work);
+	pthread_mutex_unlock(&RT.Lock);
+}
+
+void S9xSyncRenderThreads (void)
+{
+	if (!RT.Count)
+		return;
+
+	pthread_mutex_lock(&RT.Lock);
+
+	for (int i = 0; i < RT.Count; i++)
+		while (RT.Thread[i].Next != RT.Queued)
+			pthread_cond_wait(&RT.Idle, &RT.Lock);
+
+	// Every thread is waiting for work, so the queue can start over
+	RT.Queued = 0;
+	RT.ArenaUsed = 0;
+	for (int i = 0; i < RT.Count; i++)
+		RT.Thread[i].Next = 0;
+
+	pthread_mutex_unlock(&RT.Lock);
+}
+
+static uint32 ArenaAlloc (uint32 size)
+{
+	uint32	offset = RT.ArenaUsed;
+
+	RT.ArenaUsed += (size + 7) & ~7;
+
+	return (offset);
+}
+
+static void * RenderThreadMain (void *arg)
+{
+	struct SRenderThread	*t = (struct SRenderThread *) arg;
+
+	// PPU, IPPU, GFX and BG are thread-local, so this thread's copies start
+	// out empty and only ever hold what the packets put there.
+	IPPU.TileCache = t->TileCache;
+	for (int c = 0; c < 7; c++)
+		IPPU.TileCached[c] = t->TileCached[c];
+
+	IPPU.DirectColourMapsNeedRebuild = TRUE;
+	GFX.VRAM = t->VRAM;
+	GFX.FillRAM = t->FillRAM;
+
+	pthread_mutex_lock(&RT.Lock);
+
+	for (;;)
+	{
+		while (t->Next == RT.Queued && !RT.Quit)
+			pthread_cond_wait(&RT.Work, &RT.Lock);
+
+		if (RT.Quit)
+			break;
+
+		uint32	first = t->Next, last = RT.Queued;
+
+		pthread_mutex_unlock(&RT.Lock);
+
+		for (uint32 i = first; i < last; i++)
+			ApplyPacket(t, &RT.Packet[i]);
+
+		pthread_mutex_lock(&RT.Lock);
+		t->Next = last;
+		if (last == RT.Queued)
+			pthread_cond_broadcast(&RT.Idle);
+	}
+
+	pthread_mutex_unlock(&RT.Lock);
+
+	return (NULL);
+}
+
+static void ApplyPacket (struct SRenderThread *t, struct SRenderPacket *p)
+{
+	// VRAM changes and palette rebuilds apply whether or not the packet
+	// touches this thread's band, later packets depend on them.
+	uint16	*block = (uint16 *) (RT.Arena + p->VRAMOffset);
+	uint8	*data  = (uint8 *) (block + p->VRAMBlocks);
+
+	for (uint32 i = 0; i < p->VRAMBlocks; i++, data += 1 << VRAM_DIRTY_SHIFT)
+	{
+		uint32	address = block[i] << VRAM_DIRTY_SHIFT;
+
+		memcpy(t->VRAM + address, data, 1 << VRAM_DIRTY_SHIFT);
+		InvalidateTiles(address);
+	}
+
+	if (p->RebuildDirectColourMaps)
+		IPPU.DirectColourMapsNeedRebuild = TRUE;
+
+	uint32	StartY = p->StartY > t->First ? p->StartY : t->First;
+	uint32	EndY   = p->EndY   < t->Last  ? p->EndY   : t->Last;
+
+	if (StartY > EndY)
+		return;
+
+	PPU = p->PPU;
+	memcpy(IPPU.Clip, p->Clip, sizeof(p->Clip));
+	memcpy(IPPU.ScreenColors, p->ScreenColors, sizeof(p->ScreenColors));
+	IPPU.XB = p->XB;
+	IPPU.Interlace = p->Interlace;
+	IPPU.PseudoHires = p->PseudoHires;
+	IPPU.DoubleWidthPixels = p->DoubleWidthPixels;
+	IPPU.RenderedScreenWidth = p->RenderedScreenWidth;
+
+	GFX.Screen = p->Screen;
+	GFX.SubScreen = p->SubScreen;
+	GFX.ZBuffer = p->ZBuffer;
+	GFX.SubZBuffer = p->SubZBuffer;
+	GFX.X2 = p->X2;
+	GFX.ZERO = p->ZERO;
+	GFX.RealPPL = p->RealPPL;
+	GFX.PPL = p->PPL;
+	GFX.FixedColour = p->FixedColour;
+	GFX.DoInterlace = p->DoInterlace;
+	GFX.InterlaceFrame = p->InterlaceFrame;
+	memcpy(GFX.OBJWidths, p->OBJWidths, sizeof(GFX.OBJWidths));
+	memcpy(GFX.OBJVisibleTiles, p->OBJVisibleTiles, sizeof(GFX.OBJVisibleTiles));
+	memcpy(&GFX.OBJLines[StartY], RT.Arena + p->OBJLinesOffset + (StartY - p->StartY) * sizeof(GFX.OBJLines[0]), (EndY - StartY + 1) * sizeof(GFX.OBJLines[0]));
+#ifdef GFX_MULTI_FORMAT
+	GFX.PixelFormat = p->PixelFormat;
+	GFX.BuildPixel = p->BuildPixel;
+	GFX.BuildPixel2 = p->BuildPixel2;
+	GFX.DecomposePixel = p->DecomposePixel;
+#endif
+
+	memcpy(t->FillRAM + 0x2100, p->FillRAM, sizeof(p->FillRAM));
+
+	GFX.StartY = StartY;
+	GFX.EndY   = EndY;
+	S9xRenderLines();
+}
+
+static void InvalidateTiles (uint32 address)
+{
+	// Same as the VRAM write handlers in ppu.h, for a whole block at once.
+	// The hires tile variants also read the following tile.
+	uint32	t2 = address >> 4, t4 = address >> 5;
+
+	for (uint32 i = t2 - 1; i != t2 + (1 << (VRAM_DIRTY_SHIFT - 4)); i++)
+	{
+		if (i != t2 - 1)
+			IPPU.TileCached[TILE_2BIT][i & (MAX_2BIT_TILES - 1)] = FALSE;
+		IPPU.TileCached[TILE_2BIT_EVEN][i & (MAX_2BIT_TILES - 1)] = FALSE;
+		IPPU.TileCached[TILE_2BIT_ODD] [i & (MAX_2BIT_TILES - 1)] = FALSE;
+	}
+
+	for (uint32 i = t4 - 1; i != t4 + (1 << (VRAM_DIRTY_SHIFT - 5)); i++)
+	{
+		if (i != t4 - 1)
+			IPPU.TileCached[TILE_4BIT][i & (MAX_4BIT_TILES - 1)] = FALSE;
+		IPPU.TileCached[TILE_4BIT_EVEN][i & (MAX_4BIT_TILES - 1)] = FALSE;
+		IPPU.TileCached[TILE_4BIT_ODD] [i & (MAX_4BIT_TILES - 1)] = FALSE;
+	}
+
+	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
+}
+
+static void FreeRenderThread (struct SRenderThread *t)
+{
+	if (t->VRAM)    { free(t->VRAM);    t->VRAM    = NULL; }
+	if (t->FillRAM) { free(t->FillRAM); t->FillRAM = NULL; }
+
+	S9xDeinitTileCache(&t->TileCache);
+
+	for (int c = 0; c < 7; c++)
+	{
+		if (t->TileCached[c]) { free(t->TileCached[c]); t->TileCached[c] = NULL; }
+	}
+}
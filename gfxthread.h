@@ -0,0 +1,93 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#ifndef _GFXTHREAD_H_
+#define _GFXTHREAD_H_
+
+// With Settings.RenderThreads > 1, S9xUpdateScreen() does not draw on the
+// emulation thread. It records what the renderer needs for the pending run
+// of lines (PPU registers, clip windows, palette, sprite line lists and the
+// VRAM changed since the previous packet) and hands it to a pool of render
+// threads. Each thread owns a horizontal band of the screen and a private
+// copy of VRAM and the tile caches; it applies every packet in order and
+// draws only the lines that fall in its band. S9xSyncRenderThreads() waits
+// for the queue to drain and is called before anything reads or rewrites
+// lines already handed off.
+
+#define MAX_RENDER_THREADS		8
+
+// VRAM changes are forwarded to the render threads in blocks of this size.
+#define VRAM_DIRTY_SHIFT		6
+#define VRAM_DIRTY_BLOCKS		(0x10000 >> VRAM_DIRTY_SHIFT)
+
+// Line skipping wants to know when a region was last written. Every tilemap
+// and character base is a multiple of 2KB, so pages of that size are enough.
+#define VRAM_STAMP_SHIFT		11
+#define VRAM_STAMP_PAGES		(0x10000 >> VRAM_STAMP_SHIFT)
+
+struct SVRAMDirty
+{
+	uint32	Count;
+	uint16	List[VRAM_DIRTY_BLOCKS];
+	uint8	Flag[VRAM_DIRTY_BLOCKS];
+	uint32	Epoch;
+	uint32	Stamp[VRAM_STAMP_PAGES];
+};
+
+extern struct SVRAMDirty	VRAMDirty;
+
+bool8 S9xInitRenderThreads (int);
+void S9xDeinitRenderThreads (void);
+bool8 S9xRenderThreadsRunning (void);
+void S9xQueueRenderLines (void);
+void S9xSyncRenderThreads (void);
+void S9xMarkAllVRAMDirty (void);
+void S9xGetRenderThreadStats (uint32 *, uint32 *);
+
+static inline void S9xMarkVRAMDirty (uint32 address)
+{
+	uint32	b = (address & 0xffff) >> VRAM_DIRTY_SHIFT;
+
+	VRAMDirty.Stamp[(address & 0xffff) >> VRAM_STAMP_SHIFT] = VRAMDirty.Epoch;
+
+	if (!VRAMDirty.Flag[b])
+	{
+		VRAMDirty.Flag[b] = TRUE;
+		VRAMDirty.List[VRAMDirty.Count++] = b;
+	}
+}
+
+#endif
@@ -184,6 +184,8 @@
 #include "fxemu.h"
 #include "srtc.h"
 #include "cheats.h"
+#include "profiler.h"
+#include "gfxthread.h"
 #ifdef NETPLAY_SUPPORT
 #include "netplay.h"
 #endif
@@ -194,13 +196,15 @@
 
 struct SCPUState		CPU;
 struct SICPU			ICPU;
+struct SIdleLoop		IdleLoop;
+struct STimeline		Timeline;
 struct SRegisters		Registers;
-struct SPPU				PPU;
-struct InternalPPU		IPPU;
+S9X_THREAD_LOCAL struct SPPU			PPU;
+S9X_THREAD_LOCAL struct InternalPPU	IPPU;
 struct SDMA				DMA[8];
 struct STimings			Timings;
-struct SGFX				GFX;
-struct SBG				BG;
+S9X_THREAD_LOCAL struct SGFX			GFX;
+S9X_THREAD_LOCAL struct SBG			BG;
 struct SLineData		LineData[240];
 struct SLineMatrixData	LineMatrixData[240];
 struct SDSP0			DSP0;
@@ -223,6 +227,8 @@ struct SBSX				BSX;
 struct SMulti			Multi;
 struct SSettings		Settings;
 struct SSNESGameFixes	SNESGameFixes;
+struct SProfiler		Profiler;
+struct SVRAMDirty		VRAMDirty;
 #ifdef NETPLAY_SUPPORT
 struct SNetPlay			NetPlay;
 #endif
@@ -237,7 +243,7 @@ char	String[513];
 uint8	OpenBus = 0;
 uint8	*HDMAMemPointers[8];
 uint16	BlackColourMap[256];
-uint16	DirectColourMaps[8][256];
+S9X_THREAD_LOCAL uint16	DirectColourMaps[8][256];
 
 SnesModel	M1SNES = { 1, 3, 2 };
 SnesModel	M2SNES = { 2, 4, 3 };
@@ -974,13 +974,16 @@ get_filter_scale (int &width, int &height)
     return;
 }
 
+/* burst_phase is the NTSC burst phase of the first line, which is not 0
+ * for a band below the top of the frame */
 static void
 internal_filter (uint8 *src_buffer,
                  int   src_pitch,
                  uint8 *dst_buffer,
                  int   dst_pitch,
                  int   &width,
-                 int   &height)
+                 int   &height,
+                 int   burst_phase)
 {
     switch (gui_config->scale_method)
     {
@@ -1127,7 +1130,7 @@ internal_filter (uint8 *src_buffer,
                 snes_ntsc_blit_hires (&snes_ntsc,
                                       (SNES_NTSC_IN_T *) src_buffer,
                                       src_pitch >> 1,
-                                      0, /* Burst_phase */
+                                      burst_phase,
                                       width,
                                       height,
                                       (void *) dst_buffer,
@@ -1136,7 +1139,7 @@ internal_filter (uint8 *src_buffer,
                 snes_ntsc_blit (&snes_ntsc,
                                 (SNES_NTSC_IN_T *) src_buffer,
                                 src_pitch >> 1,
-                                0, /* Burst_phase */
+                                burst_phase,
                                 width,
                                 height,
                                 (void *) dst_buffer,
@@ -1167,15 +1170,6 @@ thread_worker (gpointer data,
 
     switch (job->operation_type)
     {
-        case JOB_FILTER:
-            internal_filter (job->src_buffer,
-                             job->src_pitch,
-                             job->dst_buffer,
-                             job->dst_pitch,
-                             job->width,
-                             job->height);
-            break;
-
         case JOB_CONVERT:
             internal_convert (job->src_buffer,
                               job->dst_buffer,
@@ -1354,6 +1348,30 @@ internal_threaded_convert_mask (void *src_buffer,
     return;
 }
 
+static void
+filter_band (void  *data,
+             uint8 *src_buffer,
+             int   src_pitch,
+             uint8 *dst_buffer,
+             int   dst_pitch,
+             int   width,
+             int   height,
+             int   top,
+             int   rows)
+{
+    int height_scale = *((int *) data);
+
+    internal_filter (src_buffer + (src_pitch * top),
+                     src_pitch,
+                     dst_buffer + (dst_pitch * top * height_scale),
+                     dst_pitch,
+                     width,
+                     rows,
+                     top % snes_ntsc_burst_count);
+
+    return;
+}
+
 static void
 internal_threaded_filter (uint8 *src_buffer,
                           int   src_pitch,
@@ -1362,57 +1380,22 @@ internal_threaded_filter (uint8 *src_buffer,
                           int   &width,
                           int   &height)
 {
-    int i, flag;
     int dwidth = width, dheight = height;
-    int src_coverage = 0, dst_coverage = 0;
     int height_scale;
 
     get_filter_scale (dwidth, dheight);
     height_scale = dheight / height;
 
-    /* If the threadpool doesn't exist, create it */
-    create_thread_pool ();
-
-    for (i = 0; i < gui_config->num_threads - 1; i++)
-    {
-        job[i].operation_type = JOB_FILTER;
-        job[i].complete = 0;
-        job[i].width = width;
-        job[i].src_pitch = src_pitch;
-        job[i].dst_pitch = dst_pitch;
-        job[i].src_buffer = src_buffer + (src_pitch * src_coverage);
-        job[i].dst_buffer = dst_buffer + (dst_pitch * dst_coverage);
-
-        job[i].height = (height / gui_config->num_threads) & ~3; /* Cut to multiple of 4 */
-        src_coverage += job[i].height;
-        dst_coverage += job[i].height * height_scale;
-
-
-        g_thread_pool_push (pool, (gpointer) &(job[i]), NULL);
-    }
-
-    job[i].operation_type = JOB_FILTER;
-    job[i].width = width;
-    job[i].src_pitch = src_pitch;
-    job[i].dst_pitch = dst_pitch;
-    job[i].src_buffer = src_buffer + (src_pitch * src_coverage);
-    job[i].dst_buffer = dst_buffer + (dst_pitch * dst_coverage);
-
-    job[i].height = height - src_coverage;
-
-    thread_worker ((gpointer) &(job[i]), NULL);
-
-    while (1)
-    {
-        flag = 1;
-        for (i = 0; i < gui_config->num_threads - 1; i++)
-            flag = flag && job[i].complete;
-
-        if (flag)
-            break;
-
-        sched_yield ();
-    }
+    /* The filters read a line either side of their band, which the
+     * band above or below only reads too, so the bands can run at once */
+    S9xBlitBands (filter_band,
+                  &height_scale,
+                  src_buffer,
+                  src_pitch,
+                  dst_buffer,
+                  dst_pitch,
+                  width,
+                  height);
 
     get_filter_scale (width, height);
 
@@ -1441,7 +1424,8 @@ S9xFilter (uint8 *src_buffer,
                          dst_buffer,
                          dst_pitch,
                          width,
-                         height);
+                         height,
+                         0);
 
     return;
 }
@@ -1559,6 +1543,8 @@ ntsc_filter_init (void)
 void
 S9xDisplayReconfigure (void)
 {
+    int blit_threads = gui_config->multithreading ? gui_config->num_threads : 1;
+
     ntsc_filter_init ();
 
     if (pool)
@@ -1566,6 +1552,9 @@ S9xDisplayReconfigure (void)
         g_thread_pool_set_max_threads (pool, gui_config->num_threads - 1, NULL);
     }
 
+    if (S9xBlitThreadCount () != blit_threads)
+        S9xInitBlitThreads (blit_threads);
+
     return;
 }
 
@@ -1747,6 +1736,8 @@ S9xDeinitDisplay (void)
     if (pool)
         g_thread_pool_free (pool, FALSE, TRUE);
 
+    S9xDeinitBlitThreads ();
+
     return;
 }
 
@@ -7,6 +7,7 @@
 #include "filter/hq2x.h"
 #endif
 #include "filter/epx.h"
+#include "filter/blitthread.h"
 #include "filter_epx_unsafe.h"
 
 #define FILTER_NONE                 0
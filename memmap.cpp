@@ -198,6 +198,7 @@
 #include "srtc.h"
 #include "controls.h"
 #include "cheats.h"
+#include "tile.h"
 // BeagleSNES #include "movie.h"
 #include "reader.h"
 #include "display.h"
@@ -1067,14 +1068,6 @@ bool8 CMemory::Init (void)
     VRAM = (uint8 *) malloc(0x10000);
     ROM  = (uint8 *) malloc(MAX_ROM_SIZE + 0x200 + 0x8000);
 
-	IPPU.TileCache[TILE_2BIT]       = (uint8 *) malloc(MAX_2BIT_TILES * 64);
-	IPPU.TileCache[TILE_4BIT]       = (uint8 *) malloc(MAX_4BIT_TILES * 64);
-	IPPU.TileCache[TILE_8BIT]       = (uint8 *) malloc(MAX_8BIT_TILES * 64);
-	IPPU.TileCache[TILE_2BIT_EVEN]  = (uint8 *) malloc(MAX_2BIT_TILES * 64);
-	IPPU.TileCache[TILE_2BIT_ODD]   = (uint8 *) malloc(MAX_2BIT_TILES * 64);
-	IPPU.TileCache[TILE_4BIT_EVEN]  = (uint8 *) malloc(MAX_4BIT_TILES * 64);
-	IPPU.TileCache[TILE_4BIT_ODD]   = (uint8 *) malloc(MAX_4BIT_TILES * 64);
-
 	IPPU.TileCached[TILE_2BIT]      = (uint8 *) malloc(MAX_2BIT_TILES);
 	IPPU.TileCached[TILE_4BIT]      = (uint8 *) malloc(MAX_4BIT_TILES);
 	IPPU.TileCached[TILE_8BIT]      = (uint8 *) malloc(MAX_8BIT_TILES);
@@ -1084,13 +1077,7 @@ bool8 CMemory::Init (void)
 	IPPU.TileCached[TILE_4BIT_ODD]  = (uint8 *) malloc(MAX_4BIT_TILES);
 
 	if (!RAM || !SRAM || !VRAM || !ROM ||
-		!IPPU.TileCache[TILE_2BIT]       ||
-		!IPPU.TileCache[TILE_4BIT]       ||
-		!IPPU.TileCache[TILE_8BIT]       ||
-		!IPPU.TileCache[TILE_2BIT_EVEN]  ||
-		!IPPU.TileCache[TILE_2BIT_ODD]   ||
-		!IPPU.TileCache[TILE_4BIT_EVEN]  ||
-		!IPPU.TileCache[TILE_4BIT_ODD]   ||
+		!S9xInitTileCache(&IPPU.TileCache, Settings.TileCacheSize) ||
 		!IPPU.TileCached[TILE_2BIT]      ||
 		!IPPU.TileCached[TILE_4BIT]      ||
 		!IPPU.TileCached[TILE_8BIT]      ||
@@ -1108,14 +1095,6 @@ bool8 CMemory::Init (void)
 	ZeroMemory(VRAM, 0x10000);
 	ZeroMemory(ROM,  MAX_ROM_SIZE + 0x200 + 0x8000);
 
-	ZeroMemory(IPPU.TileCache[TILE_2BIT],       MAX_2BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_4BIT],       MAX_4BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_8BIT],       MAX_8BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_2BIT_EVEN],  MAX_2BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_2BIT_ODD],   MAX_2BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_4BIT_EVEN],  MAX_4BIT_TILES * 64);
-	ZeroMemory(IPPU.TileCache[TILE_4BIT_ODD],   MAX_4BIT_TILES * 64);
-
 	ZeroMemory(IPPU.TileCached[TILE_2BIT],      MAX_2BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT],      MAX_4BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_8BIT],      MAX_8BIT_TILES);
@@ -1177,14 +1156,10 @@ void CMemory::Deinit (void)
 		ROM = NULL;
 	}
 
+	S9xDeinitTileCache(&IPPU.TileCache);
+
 	for (int t = 0; t < 7; t++)
 	{
-		if (IPPU.TileCache[t])
-		{
-			free(IPPU.TileCache[t]);
-			IPPU.TileCache[t] = NULL;
-		}
-
 		if (IPPU.TileCached[t])
 		{
 			free(IPPU.TileCached[t]);
@@ -2857,6 +2832,27 @@ void CMemory::map_WRAM (void)
 	map_space(0x7f, 0x7f, 0x0000, 0xffff, RAM + 0x10000);
 }
 
+void CMemory::map_SA1Shared (void)
+{
+	// must be called after the SA1 map copy
+	// main CPU accesses to I-RAM and BW-RAM go through the switch so a batched SA1 can catch up first
+	if (!Settings.SA1Batch)
+		return;
+
+	for (int c = 0x000; c < 0x400; c += 0x10)
+	{
+		Map[c + 3] = Map[c + 0x803] = (uint8 *) MAP_SA1SHARED;
+		WriteMap[c + 3] = WriteMap[c + 0x803] = (uint8 *) MAP_SA1SHARED;
+	}
+
+	// BW-RAM in banks 40-4f and its mirrors up to the WRAM banks, where the map has not put ROM over them
+	for (int c = 0x400; c < 0x7e0; c++)
+	{
+		if (BlockIsRAM[c])
+			Map[c] = WriteMap[c] = (uint8 *) MAP_SA1SHARED;
+	}
+}
+
 void CMemory::map_LoROMSRAM (void)
 {
 	map_index(0x70, 0x7f, 0x0000, 0x7fff, MAP_LOROM_SRAM, MAP_TYPE_RAM);
@@ -3216,6 +3212,8 @@ void CMemory::Map_SA1LoROMMap (void)
 	for (int c = 0x600; c < 0x700; c++)
 		SA1.Map[c] = SA1.WriteMap[c] = (uint8 *) MAP_BWRAM_BITMAP;
 
+	map_SA1Shared();
+
 	BWRAM = SRAM;
 }
 
@@ -3261,6 +3259,8 @@ void CMemory::Map_GNEXTSA1LoROMMap (void)
 	for (int c = 0x600; c < 0x700; c++)
 		SA1.Map[c] = SA1.WriteMap[c] = (uint8 *) MAP_BWRAM_BITMAP;
 
+	map_SA1Shared();
+
 	BWRAM = SRAM;
 }
 
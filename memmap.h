@@ -218,6 +218,7 @@ struct CMemory
 		MAP_SETA_DSP,
 		MAP_SETA_RISC,
 		MAP_BSX,
+		MAP_SA1SHARED,
 		MAP_NONE,
 		MAP_LAST
 	};
@@ -298,6 +299,7 @@ struct CMemory
 	void	map_index (uint32, uint32, uint32, uint32, int, int);
 	void	map_System (void);
 	void	map_WRAM (void);
+	void	map_SA1Shared (void);
 	void	map_LoROMSRAM (void);
 	void	map_HiROMSRAM (void);
 	void	map_DSP (void);
@@ -195,7 +195,12 @@
 #include <windows.h>
 #endif
 
+// Building with PIXEL_FORMAT defined (e.g. -DPIXEL_FORMAT=RGB565) fixes the
+// output format at compile time, so the pixel and colour math macros become
+// constants instead of calls through GFX and loads of the mask variables.
+#ifndef PIXEL_FORMAT
 #define GFX_MULTI_FORMAT
+#endif
 
 #ifdef __WIN32__
 //#define RIGHTSHIFT_IS_SAR
@@ -357,6 +362,19 @@ void SetInfoDlgColor(unsigned char, unsigned char, unsigned char);
 #define SWAP_WORD(s)		(s) = (((s) & 0xff) <<  8) | (((s) & 0xff00) >> 8)
 #define SWAP_DWORD(s)		(s) = (((s) & 0xff) << 24) | (((s) & 0xff00) << 8) | (((s) & 0xff0000) >> 8) | (((s) & 0xff000000) >> 24)
 
+// With RENDER_THREADS the renderer state (PPU, IPPU, GFX, BG) is per thread
+// so that render threads can each work from their own copy. Other builds keep
+// plain globals, since every access to thread-local storage costs a little.
+#if !defined(RENDER_THREADS)
+#define S9X_THREAD_LOCAL
+#elif defined(__GNUC__)
+#define S9X_THREAD_LOCAL	__thread
+#elif defined(_MSC_VER)
+#define S9X_THREAD_LOCAL	__declspec(thread)
+#else
+#define S9X_THREAD_LOCAL
+#endif
+
 #include "pixform.h"
 
 #endif
@@ -186,6 +186,7 @@
 #include "controls.h"
 // BeagleSNES #include "movie.h"
 #include "display.h"
+#include "profiler.h"
 #ifdef NETPLAY_SUPPORT
 #include "netplay.h"
 #endif
@@ -1052,6 +1053,8 @@ void S9xSetPPU (uint8 Byte, uint16 Address)
 		else
 		if (Settings.SA1     && Address >= 0x2200)
 		{
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			if (Address <= 0x23ff)
 				S9xSetSA1(Byte, Address);
 			else
@@ -1317,7 +1320,11 @@ uint8 S9xGetPPU (uint16 Address)
 			return (S9xGetSuperFX(Address));
 		else
 		if (Settings.SA1     && Address >= 0x2200)
+		{
+			if (SA1.BatchSlots)
+				S9xSA1Sync();
 			return (S9xGetSA1(Address));
+		}
 		else
 		if (Settings.BS      && Address >= 0x2188 && Address <= 0x219f)
 			return (S9xGetBSXPPU(Address));
@@ -1583,22 +1590,27 @@ void S9xSetCPU (uint8 Byte, uint16 Address)
 				// XXX: Not quite right...
 				if (Byte)
 					CPU.Cycles += Timings.DMACPUSync;
-				if (Byte & 0x01)
-					S9xDoDMA(0);
-				if (Byte & 0x02)
-					S9xDoDMA(1);
-				if (Byte & 0x04)
-					S9xDoDMA(2);
-				if (Byte & 0x08)
-					S9xDoDMA(3);
-				if (Byte & 0x10)
-					S9xDoDMA(4);
-				if (Byte & 0x20)
-					S9xDoDMA(5);
-				if (Byte & 0x40)
-					S9xDoDMA(6);
-				if (Byte & 0x80)
-					S9xDoDMA(7);
+
+				{
+					PROFILE_BEGIN(PROF_DMA);
+					if (Byte & 0x01)
+						S9xDoDMA(0);
+					if (Byte & 0x02)
+						S9xDoDMA(1);
+					if (Byte & 0x04)
+						S9xDoDMA(2);
+					if (Byte & 0x08)
+						S9xDoDMA(3);
+					if (Byte & 0x10)
+						S9xDoDMA(4);
+					if (Byte & 0x20)
+						S9xDoDMA(5);
+					if (Byte & 0x40)
+						S9xDoDMA(6);
+					if (Byte & 0x80)
+						S9xDoDMA(7);
+					PROFILE_END();
+				}
 			#ifdef DEBUGGER
 				missing.dma_this_frame = Byte;
 				missing.dma_channels = Byte;
@@ -1846,6 +1858,8 @@ void S9xSoftResetPPU (void)
 		PPU.CGDATA[c] = IPPU.Red[c] | (IPPU.Green[c] << 5) | (IPPU.Blue[c] << 10);
 	}
 
+	IPPU.CGRAMGeneration++;
+
 	for (int c = 0; c < 128; c++)
 	{
 		PPU.OBJ[c].HPos = 0;
@@ -1946,6 +1960,7 @@ void S9xSoftResetPPU (void)
 		memset(&IPPU.Clip[c], 0, sizeof(struct ClipData));
 	IPPU.ColorsChanged = TRUE;
 	IPPU.OBJChanged = TRUE;
+	memset(IPPU.OBJDirty, 0xff, sizeof(IPPU.OBJDirty));
 	IPPU.DirectColourMapsNeedRebuild = TRUE;
 	ZeroMemory(IPPU.TileCached[TILE_2BIT], MAX_2BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT], MAX_4BIT_TILES);
@@ -1954,6 +1969,7 @@ void S9xSoftResetPPU (void)
 	ZeroMemory(IPPU.TileCached[TILE_2BIT_ODD],  MAX_2BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT_EVEN], MAX_4BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT_ODD],  MAX_4BIT_TILES);
+	S9xMarkAllVRAMDirty();
 	IPPU.VRAMReadBuffer = 0; // XXX: FIXME: anything better?
 	IPPU.Interlace = FALSE;
 	IPPU.InterlaceOBJ = FALSE;
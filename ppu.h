@@ -192,6 +192,7 @@
 #define MAX_2BIT_TILES		4096
 #define MAX_4BIT_TILES		2048
 #define MAX_8BIT_TILES		1024
+#define MAX_CACHED_TILES	(MAX_2BIT_TILES * 3 + MAX_4BIT_TILES * 3 + MAX_8BIT_TILES)
 
 #define CLIP_OR				0
 #define CLIP_AND			1
@@ -206,13 +207,35 @@ struct ClipData
 	uint16	Right[6];
 };
 
+// Converted tiles live in a fixed pool of 64-byte slots, shared by all seven formats.
+// TileCached[] still says whether a tile is up to date (and whether it is blank);
+// Slot[] says where its pixels are, if they have not been evicted since.
+struct STileCache
+{
+	uint8	*Data;
+	uint16	*Slot[7];			// slot + 1 for each tile, 0 if not resident
+	uint16	*Owner;				// format << 12 | tile, for each slot
+	uint16	*Prev;				// LRU list, most recently used at Head
+	uint16	*Next;
+	uint32	Slots;
+	uint32	Used;
+	uint16	Head;
+	uint16	Tail;
+	bool8	Bounded;			// FALSE if every tile has a slot, so nothing is ever evicted
+	uint32	Hits;
+	uint32	Misses;
+	uint32	Evictions;
+};
+
 struct InternalPPU
 {
 	struct ClipData Clip[2][6];
 	bool8	ColorsChanged;
+	uint32	CGRAMGeneration;
 	bool8	OBJChanged;
+	uint32	OBJDirty[4];	// sprites whose position, size or vertical flip changed
 	bool8	DirectColourMapsNeedRebuild;
-	uint8	*TileCache[7];
+	struct STileCache	TileCache;
 	uint8	*TileCached[7];
 	uint16	VRAMReadBuffer;
 	bool8	Interlace;
@@ -367,8 +390,8 @@ struct SPPU
 };
 
 extern uint16				SignExtend[2];
-extern struct SPPU			PPU;
-extern struct InternalPPU	IPPU;
+extern S9X_THREAD_LOCAL struct SPPU			PPU;
+extern S9X_THREAD_LOCAL struct InternalPPU	IPPU;
 
 void S9xResetPPU (void);
 void S9xSoftResetPPU (void);
@@ -382,6 +405,7 @@ void S9xDoAutoJoypad (void);
 
 #include "gfx.h"
 #include "memmap.h"
+#include "gfxthread.h"
 
 typedef struct
 {
@@ -414,6 +438,7 @@ static inline void REGISTER_2104 (uint8 Byte)
 			FLUSH_REDRAW();
 			PPU.OAMData[addr] = Byte;
 			IPPU.OBJChanged = TRUE;
+			IPPU.OBJDirty[(addr >> 3) & 3] |= 0xf << ((addr & 7) << 2);
 
 			// X position high bit, and sprite size (x4)
 			struct SOBJ *pObj = &PPU.OBJ[(addr & 0x1f) * 4];
@@ -464,6 +489,9 @@ static inline void REGISTER_2104 (uint8 Byte)
 		if (lowbyte != PPU.OAMData[addr] || highbyte != PPU.OAMData[addr + 1])
 		{
 			FLUSH_REDRAW();
+			// Name, palette, priority and H flip don't move the sprite between lines
+			if (!(addr & 2) || ((highbyte ^ PPU.OAMData[addr + 1]) & 0x80))
+				IPPU.OBJDirty[PPU.OAMAddr >> 6] |= 1 << ((PPU.OAMAddr >> 1) & 31);
 			PPU.OAMData[addr] = lowbyte;
 			PPU.OAMData[addr + 1] = highbyte;
 			IPPU.OBJChanged = TRUE;
@@ -527,6 +555,7 @@ static inline void REGISTER_2118 (uint8 Byte)
 	else
 		Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -564,6 +593,7 @@ static inline void REGISTER_2119 (uint8 Byte)
 	else
 		Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -595,6 +625,7 @@ static inline void REGISTER_2118_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -620,6 +651,7 @@ static inline void REGISTER_2119_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -644,6 +676,7 @@ static inline void REGISTER_2118_linear (uint8 Byte)
 
 	Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -668,6 +701,7 @@ static inline void REGISTER_2119_linear (uint8 Byte)
 
 	Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
+	S9xMarkVRAMDirty(address);
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -694,6 +728,7 @@ static inline void REGISTER_2122 (uint8 Byte)
 			PPU.CGDATA[PPU.CGADD] &= 0x00ff;
 			PPU.CGDATA[PPU.CGADD] |= (Byte & 0x7f) << 8;
 			IPPU.ColorsChanged = TRUE;
+			IPPU.CGRAMGeneration++;
 			IPPU.Blue[PPU.CGADD] = IPPU.XB[(Byte >> 2) & 0x1f];
 			IPPU.Green[PPU.CGADD] = IPPU.XB[(PPU.CGDATA[PPU.CGADD] >> 5) & 0x1f];
 			IPPU.ScreenColors[PPU.CGADD] = (uint16) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
@@ -709,6 +744,7 @@ static inline void REGISTER_2122 (uint8 Byte)
 			PPU.CGDATA[PPU.CGADD] &= 0x7f00;
 			PPU.CGDATA[PPU.CGADD] |= Byte;
 			IPPU.ColorsChanged = TRUE;
+			IPPU.CGRAMGeneration++;
 			IPPU.Red[PPU.CGADD] = IPPU.XB[Byte & 0x1f];
 			IPPU.Green[PPU.CGADD] = IPPU.XB[(PPU.CGDATA[PPU.CGADD] >> 5) & 0x1f];
 			IPPU.ScreenColors[PPU.CGADD] = (uint16) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
@@ -0,0 +1,168 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#include "snes9x.h"
+#include "apu/apu.h"
+#include "profiler.h"
+
+static const char	*section_names[PROF_SECTIONS] =
+{
+	"65c816",
+	"APU",
+	"Render",
+	"DMA/HDMA",
+	"SA1",
+	"SuperFX",
+	"DSP",
+	"SPC7110",
+	"HEvent",
+	"Present",
+	"Sync",
+	"Other"
+};
+
+
+void S9xProfilerReset (void)
+{
+	for (int i = 0; i < PROF_SECTIONS; i++)
+	{
+		Profiler.Time[i] = 0;
+		Profiler.Calls[i] = 0;
+		Profiler.FrameTime[i] = 0;
+	}
+
+	Profiler.MixTime = 0;
+	Profiler.FrameMix = 0;
+	Profiler.FrameCount = 0;
+	Profiler.Current = PROF_OTHER;
+	Profiler.Stamp = Profiler.FrameStamp = S9xProfilerClock();
+}
+
+void S9xProfilerStart (uint32 mask)
+{
+	Profiler.Current = PROF_OTHER;
+	Profiler.Stamp = Profiler.FrameStamp = S9xProfilerClock();
+	Profiler.Mask = mask;
+}
+
+void S9xProfilerStop (void)
+{
+	if (!Profiler.Mask)
+		return;
+
+	Profiler.Time[Profiler.Current] += S9xProfilerClock() - Profiler.Stamp;
+	Profiler.Mask = 0;
+}
+
+// Called once per emulated frame, from the end of S9xMainLoop() after the
+// frame has been synced.
+void S9xProfilerEndFrame (void)
+{
+	if (!Profiler.Mask)
+		return;
+
+	uint64	now = S9xProfilerClock();
+
+	Profiler.Time[Profiler.Current] += now - Profiler.Stamp;
+	Profiler.Stamp = now;
+
+	struct SProfilerFrame	*f = &Profiler.Frames[Profiler.FrameCount % PROF_HISTORY];
+
+	for (int i = 0; i < PROF_SECTIONS; i++)
+	{
+		f->Time[i] = (uint32) ((Profiler.Time[i] - Profiler.FrameTime[i]) / 1000);
+		Profiler.FrameTime[i] = Profiler.Time[i];
+	}
+
+	uint32	mix = Profiler.MixTime;
+	int		filled, capacity;
+
+	S9xGetSoundBufferLevel(&filled, &capacity);
+
+	f->Mix = (mix - Profiler.FrameMix) / 1000;
+	f->RateAdjust = S9xGetDynamicRateAdjust();
+	f->SoundFill = capacity ? (uint16) (filled * 1000 / capacity) : 0;
+	f->Total = (uint32) ((now - Profiler.FrameStamp) / 1000);
+	Profiler.FrameMix = mix;
+	Profiler.FrameStamp = now;
+	Profiler.FrameCount++;
+}
+
+// 0 is the most recently completed frame, 1 the one before it, and so on.
+const struct SProfilerFrame * S9xProfilerGetFrame (int age)
+{
+	if (age < 0 || age >= PROF_HISTORY || (uint32) age >= Profiler.FrameCount)
+		return (NULL);
+
+	return (&Profiler.Frames[(Profiler.FrameCount - 1 - age) % PROF_HISTORY]);
+}
+
+bool8 S9xProfilerDumpCSV (const char *filename)
+{
+	FILE	*fp;
+
+	if (!Profiler.FrameCount || !(fp = fopen(filename, "w")))
+		return (FALSE);
+
+	fprintf(fp, "frame,total_us");
+	for (int i = 0; i < PROF_SECTIONS; i++)
+		fprintf(fp, ",%s_us", section_names[i]);
+	fprintf(fp, ",Mix_us,rate_ppm,fill_permille\n");
+
+	int	count = Profiler.FrameCount < PROF_HISTORY ? Profiler.FrameCount : PROF_HISTORY;
+
+	for (int age = count - 1; age >= 0; age--)
+	{
+		const struct SProfilerFrame	*f = S9xProfilerGetFrame(age);
+
+		fprintf(fp, "%u,%u", Profiler.FrameCount - 1 - age, f->Total);
+		for (int i = 0; i < PROF_SECTIONS; i++)
+			fprintf(fp, ",%u", f->Time[i]);
+		fprintf(fp, ",%u,%d,%u\n", f->Mix, f->RateAdjust, f->SoundFill);
+	}
+
+	fclose(fp);
+
+	return (TRUE);
+}
+
+const char * S9xProfilerSectionName (int section)
+{
+	if (section < 0 || section >= PROF_SECTIONS)
+		return ("");
+
+	return (section_names[section]);
+}
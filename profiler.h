@@ -0,0 +1,159 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <time.h>
+
+// Sections are exclusive: entering one pauses whichever section was running,
+// so the totals add up to the wall time spent while the profiler is running.
+enum
+{
+	PROF_CPU = 0,
+	PROF_APU,
+	PROF_RENDER,
+	PROF_DMA,
+	PROF_SA1,
+	PROF_SUPERFX,
+	PROF_DSP,
+	PROF_SPC7110,
+	PROF_HEVENT,
+	PROF_PRESENT,
+	PROF_SYNC,
+	PROF_OTHER,
+	PROF_SECTIONS
+};
+
+#define PROF_MASK_ALL		((1 << PROF_SECTIONS) - 1)
+// Stages entered a few times a frame; cheap enough to leave running on the BBB.
+#define PROF_MASK_FRAME		((1 << PROF_CPU) | (1 << PROF_PRESENT) | (1 << PROF_SYNC) | (1 << PROF_OTHER))
+// Adds the per-scanline stages, for when the bars or the CSV dump are wanted.
+#define PROF_MASK_DETAIL	(PROF_MASK_FRAME | (1 << PROF_RENDER) | (1 << PROF_HEVENT))
+
+// Frames kept for the on-screen bar and the CSV dump (10 seconds at 60Hz)
+#define PROF_HISTORY		600
+
+struct SProfilerFrame
+{
+	uint32	Time[PROF_SECTIONS];	// microseconds
+	uint32	Mix;					// microseconds spent in S9xMixSamples
+	uint32	Total;					// microseconds, wall time
+	int32	RateAdjust;				// dynamic rate control, ppm
+	uint16	SoundFill;				// sound ring fill, per mille
+};
+
+struct SProfiler
+{
+	uint32	Mask;
+	int		Current;
+	uint64	Stamp;
+	uint64	Time[PROF_SECTIONS];	// nanoseconds
+	uint32	Calls[PROF_SECTIONS];
+
+	// S9xMixSamples() usually runs on the audio thread, so it keeps its own
+	// wrapping nanosecond counter outside the exclusive sections.
+	volatile uint32	MixTime;
+
+	uint32	FrameCount;
+	uint64	FrameStamp;
+	uint64	FrameTime[PROF_SECTIONS];
+	uint32	FrameMix;
+	struct SProfilerFrame	Frames[PROF_HISTORY];
+};
+
+extern struct SProfiler	Profiler;
+
+void S9xProfilerReset (void);
+void S9xProfilerStart (uint32);
+void S9xProfilerStop (void);
+void S9xProfilerEndFrame (void);
+const struct SProfilerFrame * S9xProfilerGetFrame (int);
+bool8 S9xProfilerDumpCSV (const char *);
+const char * S9xProfilerSectionName (int);
+
+static inline uint64 S9xProfilerClock (void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64) ts.tv_sec * 1000000000 + ts.tv_nsec);
+}
+
+static inline int S9xProfilerEnter (int section)
+{
+	if (!(Profiler.Mask & (1 << section)))
+		return (-1);
+
+	uint64	now = S9xProfilerClock();
+	int		prev = Profiler.Current;
+
+	Profiler.Time[prev] += now - Profiler.Stamp;
+	Profiler.Stamp = now;
+	Profiler.Current = section;
+	Profiler.Calls[section]++;
+
+	return (prev);
+}
+
+static inline void S9xProfilerLeave (int prev)
+{
+	if (prev < 0 || !Profiler.Mask)
+		return;
+
+	uint64	now = S9xProfilerClock();
+
+	Profiler.Time[Profiler.Current] += now - Profiler.Stamp;
+	Profiler.Stamp = now;
+	Profiler.Current = prev;
+}
+
+static inline uint64 S9xProfilerMixEnter (void)
+{
+	return (Profiler.Mask ? S9xProfilerClock() : 0);
+}
+
+static inline void S9xProfilerMixLeave (uint64 start)
+{
+	if (start)
+		Profiler.MixTime += (uint32) (S9xProfilerClock() - start);
+}
+
+#define PROFILE_BEGIN(section)	int _prof_prev = S9xProfilerEnter(section)
+#define PROFILE_END()			S9xProfilerLeave(_prof_prev)
+
+#endif
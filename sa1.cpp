@@ -178,6 +178,7 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "profiler.h"
 
 uint8	SA1OpenBus;
 
@@ -194,6 +195,7 @@ void S9xSA1Init (void)
 	SA1.PrevCycles = 0;
 	SA1.Flags = 0;
 	SA1.WaitingForInterrupt = FALSE;
+	SA1.BatchSlots = 0;
 
 	memset(&Memory.FillRAM[0x2200], 0, 0x200);
 	Memory.FillRAM[0x2200] = 0x20;
@@ -289,6 +291,22 @@ void S9xSA1PostLoadState (void)
 	SA1.VirtualBitmapFormat = (Memory.FillRAM[0x223f] & 0x80) ? 2 : 4;
 	Memory.BWRAM = Memory.SRAM + (Memory.FillRAM[0x2224] & 7) * 0x2000;
 	S9xSA1SetBWRAMMemMap(Memory.FillRAM[0x2225]);
+	SA1.BatchSlots = 0;
+}
+
+void S9xSA1Sync (void)
+{
+	// Run the SA1 slots the main CPU has banked up, so the SA1 is level
+	// with the main CPU before it reads or writes anything they share.
+	PROFILE_BEGIN(PROF_SA1);
+
+	while (SA1.BatchSlots > 0)
+	{
+		SA1.BatchSlots--;
+		S9xSA1MainLoop();
+	}
+
+	PROFILE_END();
 }
 
 static void S9xSetSA1MemMap (uint32 which1, uint8 map)
@@ -179,6 +179,8 @@
 #ifndef _SA1_H_
 #define _SA1_H_
 
+#define SA1_BATCH_SLOTS	32
+
 struct SSA1Registers
 {
 	uint8	DB;
@@ -228,6 +230,7 @@ struct SSA1
 	bool8	overflow;
 	uint8	VirtualBitmapFormat;
 	uint8	variable_bit_pos;
+	int32	BatchSlots;
 };
 
 #define SA1CheckCarry()		(SA1._Carry)
@@ -265,8 +268,18 @@ uint8 S9xGetSA1 (uint32);
 void S9xSetSA1 (uint8, uint32);
 void S9xSA1Init (void);
 void S9xSA1MainLoop (void);
+void S9xSA1Sync (void);
 void S9xSA1PostLoadState (void);
 
+// MAP_SA1SHARED: I-RAM in banks 00-3f/80-bf, BW-RAM in banks 40-4f and its mirrors
+static inline uint8 * S9xSA1SharedPointer (uint32 Address)
+{
+	if (Address & 0x400000)
+		return (Memory.SRAM + (Address & 0x1ffff));
+	else
+		return (Memory.FillRAM + (Address & 0xffff));
+}
+
 static inline void S9xSA1UnpackStatus (void)
 {
 	SA1._Zero = (SA1Registers.PL & Zero) == 0;
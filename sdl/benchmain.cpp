@@ -0,0 +1,1111 @@
+/*****************************************************************************
+  BeagleSNES - Super Nintendo Entertainment System (TM) emulator for the
+  BeagleBoard-xM platform.
+
+  See CREDITS file to find the copyright owners of this file.
+
+
+  BeagleSNES homepage: http://www.beaglesnes.org/
+  
+  BeagleSNES is derived from the Snes9x open source emulator:  
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute BeagleSNES in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  BeagleSNES is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for BeagleSNES or software derived 
+  from BeagleSNES, including BeagleSNES or derivatives in commercial game 
+  bundles, and/or using BeagleSNES as a promotion for your commercial 
+  product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ *****************************************************************************/
+
+// Headless benchmark driver: runs a ROM for a fixed number of frames with
+// no video, audio or input device attached and reports where the time went.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "snes9x.h"
+#include "memmap.h"
+#include "apu/apu.h"
+#include "gfx.h"
+#include "controls.h"
+#include "display.h"
+#include "conffile.h"
+#include "profiler.h"
+#include "gfxthread.h"
+#include "tile.h"
+#include "apu/resampler_simd.h"
+#include "blit.h"
+#include "blitthread.h"
+
+#define BENCH_DEFAULT_FRAMES	600
+#define BENCH_RESAMPLER_INPUT	(1 << 16)
+#define BENCH_TILE_PASSES		200
+#define BENCH_FILTER_FRAMES		120
+#define BENCH_FILTER_RUNS		5
+
+static int		bench_frames     = BENCH_DEFAULT_FRAMES;
+static int		bench_warmup     = 0;
+static bool8	bench_checksum   = FALSE;
+static bool8	bench_resampler  = FALSE;
+static bool8	bench_tiles      = FALSE;
+static bool8	bench_filters    = FALSE;
+static bool8	bench_sa1        = FALSE;
+static bool8	bench_render     = FALSE;
+static int		bench_blit_threads = 0;
+static uint32	video_checksum   = 2166136261u;
+static uint32	audio_checksum   = 2166136261u;
+static uint8	*screen_buffer   = NULL;
+static uint8	sound_buffer[16384];
+
+// The SDL GUI defines these; controls.cpp expects them to exist.
+uint8	selectButtonNum = 0xFF;
+uint8	startButtonNum  = 0xFF;
+
+static uint32 HashBytes (uint32, const uint8 *, int);
+static void DrainSamples (void);
+static void PrintReport (uint64, int);
+static void ResamplerTest (void);
+static void ResamplerRun (int, bool8, int, const float *, const float *, const int *, const double *, int, const float *, short *);
+static void TileConverterTest (void);
+static uint64 TileConverterRun (int, bool8, int, uint8 *, uint8 *);
+static void FilterTest (void);
+static void FilterFrame (uint16 *, int, int);
+static int FilterDiffs (const uint32 *, const uint32 *);
+static uint64 FilterRun (Blitter, bool8, bool8, uint8 *, uint8 *, uint32 *);
+static void ChecksumRun (const char *, uint32 *, uint32 *);
+static bool8 ChecksumCompare (const char *, int, const char **, const uint32 *, const uint32 *);
+static bool8 SA1BatchTest (const char *);
+static bool8 RenderTest (const char *);
+
+void _splitpath (const char *path, char *drive, char *dir, char *fname, char *ext)
+{
+	*drive = 0;
+
+	const char	*slash = strrchr(path, SLASH_CHAR),
+				*dot   = strrchr(path, '.');
+
+	if (dot && slash && dot < slash)
+		dot = NULL;
+
+	if (!slash)
+	{
+		*dir = 0;
+
+		strcpy(fname, path);
+
+		if (dot)
+		{
+			fname[dot - path] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+	else
+	{
+		strcpy(dir, path);
+		dir[slash - path] = 0;
+
+		strcpy(fname, slash + 1);
+
+		if (dot)
+		{
+			fname[dot - slash - 1] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+}
+
+void _makepath (char *path, const char *, const char *dir, const char *fname, const char *ext)
+{
+	if (dir && *dir)
+	{
+		strcpy(path, dir);
+		strcat(path, SLASH_STR);
+	}
+	else
+		*path = 0;
+
+	strcat(path, fname);
+
+	if (ext && *ext)
+	{
+		strcat(path, ".");
+		strcat(path, ext);
+	}
+}
+
+static uint32 HashBytes (uint32 hash, const uint8 *p, int len)
+{
+	// FNV-1a
+	while (len--)
+	{
+		hash ^= *p++;
+		hash *= 16777619u;
+	}
+
+	return (hash);
+}
+
+void S9xExtraUsage (void)
+{
+	/*                               12345678901234567890123456789012345678901234567890123456789012345678901234567890 */
+
+	S9xMessage(S9X_INFO, S9X_USAGE, "-frames <num>                   Number of frames to time (default 600)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-warmup <num>                   Frames to run before timing starts");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-checksum                       Hash every rendered frame and all audio output");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-resamplertest                  Time the resampler kernels and check them against");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                the scalar code (no ROM needed)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-tiletest                       Time the tile converters and check them against");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                the scalar code (no ROM needed)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-filtertest                     Time the scaling filters and check the vector");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                ones against the scalar code (no ROM needed)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-blitthreads <num>              With -filtertest, also draw each filter in bands");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                on <num> threads and check it against one");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-sa1test                        Run an SA-1 ROM with the SA1 stepped every opcode,");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                then batched, and check the checksums match");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-rendertest                     Run a ROM on the vector tile converters and");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                renderers, again without screen reads, then the");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                scalar ones, and check the checksums match");
+	S9xMessage(S9X_INFO, S9X_USAGE, "");
+}
+
+void S9xParseArg (char **argv, int &i, int argc)
+{
+	if (!strcasecmp(argv[i], "-frames"))
+	{
+		if (i + 1 < argc)
+			bench_frames = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-warmup"))
+	{
+		if (i + 1 < argc)
+			bench_warmup = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-checksum"))
+		bench_checksum = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-resamplertest"))
+		bench_resampler = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-tiletest"))
+		bench_tiles = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-filtertest"))
+		bench_filters = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-sa1test"))
+		bench_sa1 = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-rendertest"))
+		bench_render = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-blitthreads"))
+	{
+		if (i + 1 < argc)
+			bench_blit_threads = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+		S9xUsage();
+}
+
+void S9xParsePortConfig (ConfigFile &conf, int pass)
+{
+	return;
+}
+
+const char * S9xGetDirectory (enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+
+	// Everything lives next to the ROM; the benchmark never writes SRAM.
+	strncpy(s, Memory.ROMFilename, PATH_MAX + 1);
+	s[PATH_MAX] = 0;
+
+	char	*slash = strrchr(s, SLASH_CHAR);
+	if (slash)
+		*slash = 0;
+	else
+		strcpy(s, ".");
+
+	return (s);
+}
+
+const char * S9xGetFilename (const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	if (snprintf(s, PATH_MAX + 1, "%s%s%s%s", S9xGetDirectory(dirtype), SLASH_STR, fname, ex) > PATH_MAX)
+		fprintf(stderr, "Path too long: %s\n", s);
+
+	return (s);
+}
+
+const char * S9xGetFilenameInc (const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	unsigned int	i = 0;
+	const char		*d;
+	struct stat		buf;
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	d = S9xGetDirectory(dirtype);
+
+	do
+	{
+		// A name cut short by PATH_MAX could stat an unrelated file
+		if (snprintf(s, PATH_MAX + 1, "%s%s%s.%03d%s", d, SLASH_STR, fname, i++, ex) > PATH_MAX)
+		{
+			fprintf(stderr, "Path too long: %s\n", s);
+			break;
+		}
+	}
+	while (stat(s, &buf) == 0 && i < 1000);
+
+	return (s);
+}
+
+const char * S9xBasename (const char *f)
+{
+	const char	*p;
+
+	if ((p = strrchr(f, '/')) != NULL || (p = strrchr(f, '\\')) != NULL)
+		return (p + 1);
+
+	return (f);
+}
+
+const char * S9xChooseFilename (bool8 read_only)
+{
+	return (NULL);
+}
+
+bool8 S9xOpenSnapshotFile (const char *filename, bool8 read_only, STREAM *file)
+{
+	if ((*file = OPEN_STREAM(filename, read_only ? "rb" : "wb")))
+		return (TRUE);
+
+	return (FALSE);
+}
+
+void S9xCloseSnapshotFile (STREAM file)
+{
+	CLOSE_STREAM(file);
+}
+
+void S9xMessage (int type, int number, const char *message)
+{
+	fprintf(stderr, "%s\n", message);
+}
+
+void S9xSetPalette (void)
+{
+	return;
+}
+
+bool S9xPollButton (uint32 id, bool *pressed)
+{
+	return (false);
+}
+
+bool S9xPollAxis (uint32 id, int16 *value)
+{
+	return (false);
+}
+
+bool S9xPollPointer (uint32 id, int16 *x, int16 *y)
+{
+	return (false);
+}
+
+void S9xHandlePortCommand (s9xcommand_t cmd, int16 data1, int16 data2)
+{
+	return;
+}
+
+void S9xToggleSoundChannel (int c)
+{
+	return;
+}
+
+bool8 S9xOpenSoundDevice (void)
+{
+	// Samples are pulled once per frame in S9xSyncSpeed().
+	return (TRUE);
+}
+
+bool8 S9xInitUpdate (void)
+{
+	return (TRUE);
+}
+
+bool8 S9xDeinitUpdate (int width, int height)
+{
+	if (bench_checksum)
+	{
+		for (int y = 0; y < height; y++)
+			video_checksum = HashBytes(video_checksum, (uint8 *) GFX.Screen + y * GFX.Pitch, width * sizeof(uint16));
+	}
+
+	return (TRUE);
+}
+
+bool8 S9xContinueUpdate (int width, int height)
+{
+	return (TRUE);
+}
+
+void S9xAutoSaveSRAM (void)
+{
+	return;
+}
+
+static void DrainSamples (void)
+{
+	int	samples = S9xGetSampleCount();
+	int	max = sizeof(sound_buffer) >> 1;
+
+	while (samples > 0)
+	{
+		int	n = samples < max ? samples : max;
+
+		S9xMixSamples(sound_buffer, n);
+		if (bench_checksum)
+			audio_checksum = HashBytes(audio_checksum, sound_buffer, n << 1);
+
+		samples -= n;
+	}
+}
+
+void S9xSyncSpeed (void)
+{
+	// No pacing: run as fast as the host allows.
+	DrainSamples();
+
+	IPPU.RenderThisFrame = (++IPPU.SkippedFrames >= (uint32) Settings.SkipFrames) ? TRUE : FALSE;
+	if (IPPU.RenderThisFrame)
+		IPPU.SkippedFrames = 0;
+}
+
+void S9xExit (void)
+{
+	Settings.StopEmulation = TRUE;
+
+	S9xGraphicsDeinit();
+	Memory.Deinit();
+	S9xDeinitAPU();
+
+	exit(0);
+}
+
+static void PrintReport (uint64 elapsed, int frames)
+{
+	double	ms = (double) elapsed / 1000000.0;
+	uint64	total = 0;
+
+	for (int i = 0; i < PROF_SECTIONS; i++)
+		total += Profiler.Time[i];
+
+	printf("\n%d frames in %.1f ms: %.2f ms/frame, %.1f fps\n", frames, ms, ms / frames, frames * 1000.0 / ms);
+	printf("\n%-10s %12s %8s %12s %10s\n", "section", "total ms", "%", "us/frame", "calls");
+
+	for (int i = 0; i < PROF_SECTIONS; i++)
+	{
+		if (!Profiler.Calls[i] && !Profiler.Time[i])
+			continue;
+
+		printf("%-10s %12.2f %7.1f%% %12.1f %10u\n",
+			S9xProfilerSectionName(i),
+			(double) Profiler.Time[i] / 1000000.0,
+			total ? (double) Profiler.Time[i] * 100.0 / total : 0.0,
+			(double) Profiler.Time[i] / 1000.0 / frames,
+			Profiler.Calls[i]);
+	}
+
+	// Per-frame history only covers the last PROF_HISTORY frames.
+	const struct SProfilerFrame	*worst = NULL;
+	uint64	mix = 0;
+	int		history = 0;
+
+	for (const struct SProfilerFrame *f; (f = S9xProfilerGetFrame(history)); history++)
+	{
+		mix += f->Mix;
+		if (!worst || f->Total > worst->Total)
+			worst = f;
+	}
+
+	if (history)
+		printf("%-10s %12s %8s %12.1f %10s\n", "Mix", "", "", (double) mix / history, "");
+
+	if (worst)
+	{
+		int	top = 0;
+
+		for (int i = 1; i < PROF_SECTIONS; i++)
+			if (worst->Time[i] > worst->Time[top])
+				top = i;
+
+		printf("\nslowest frame %.2f ms, mostly %s (%.2f ms)\n", worst->Total / 1000.0, S9xProfilerSectionName(top), worst->Time[top] / 1000.0);
+	}
+
+	if (Settings.DynamicRateControl && history)
+	{
+		const struct SProfilerFrame	*last = S9xProfilerGetFrame(0);
+
+		printf("\ndynamic rate %+d ppm, sound ring %.1f%% full\n", last->RateAdjust, last->SoundFill / 10.0);
+	}
+
+	if (Settings.IdleLoopSkip)
+		printf("\nidle loops %u skips, %u cycles skipped\n", IdleLoop.Skips, IdleLoop.SkippedCycles);
+
+	if (Settings.BRRCache)
+	{
+		uint32	hits, misses;
+
+		S9xGetBRRCacheStats(&hits, &misses);
+		printf("\nBRR cache %u hits, %u misses (%.1f%% hit rate)\n", hits, misses, hits + misses ? hits * 100.0 / (hits + misses) : 0.0);
+	}
+
+	if (!S9xRenderThreadsRunning())
+	{
+		struct STileCache	*c = &IPPU.TileCache;
+
+		printf("\ntile cache %u KB, %u hits, %u misses, %u evictions (%.1f%% hit rate)\n", c->Slots * 64 / 1024, c->Hits, c->Misses, c->Evictions,
+			   c->Hits + c->Misses ? c->Hits * 100.0 / (c->Hits + c->Misses) : 0.0);
+	}
+
+	{
+		uint32	hits, misses;
+
+		S9xGetClipCacheStats(&hits, &misses);
+		printf("\nclip cache %u hits, %u misses (%.1f%% hit rate)\n", hits, misses, hits + misses ? hits * 100.0 / (hits + misses) : 0.0);
+	}
+
+	{
+		uint32	calls, full, rebinned, lines;
+
+		S9xGetOBJSetupStats(&calls, &full, &rebinned, &lines);
+		printf("\nsprite setup %u calls, %u full, %.1f sprites rebinned and %.1f lines listed per call\n", calls, full, calls ? (double) rebinned / calls : 0.0, calls ? (double) lines / calls : 0.0);
+	}
+
+	if (Settings.SkipUnchangedLines)
+	{
+		uint32	drawn, skipped;
+
+		S9xGetLineSkipStats(&drawn, &skipped);
+		printf("\nline skip %u drawn, %u reused (%.1f%% reused)\n", drawn, skipped, drawn + skipped ? skipped * 100.0 / (drawn + skipped) : 0.0);
+	}
+
+	if (S9xRenderThreadsRunning())
+	{
+		uint32	packets, blocks;
+
+		S9xGetRenderThreadStats(&packets, &blocks);
+		printf("\nrender threads %d, %u packets, %u VRAM blocks forwarded\n", Settings.RenderThreads, packets, blocks);
+	}
+
+	if (bench_checksum)
+		printf("\nvideo checksum %08x, audio checksum %08x\n", video_checksum, audio_checksum);
+}
+
+static void ResamplerRun (int simd, bool8 sinc, int passes, const float *left, const float *right, const int *pos, const double *mu, int count, const float *table, short *out)
+{
+	for (int n = 0; n < passes; n++)
+	{
+		if (sinc)
+			S9xResampleSinc(simd, left, right, pos, mu, count, table, out);
+		else
+			S9xResampleHermite(simd, left, right, pos, mu, count, out);
+	}
+}
+
+// Feeds the same planned output positions to the scalar and vector kernels.
+// The vector kernels work in float, so hermite may differ from the scalar
+// double path by one LSB where truncation lands on a boundary.
+static void ResamplerTest (void)
+{
+	static const double	ratios[] = { 32000.0 / 48000.0, 32000.0 / 44100.0, 32040.0 / 32000.0 };
+	const int	frames = BENCH_RESAMPLER_INPUT, passes = 50;
+	const int	max_out = frames * 2;
+	int			simd = S9xResamplerDetectSIMD();
+
+	float	*left  = new float[RESAMPLER_HISTORY + frames];
+	float	*right = new float[RESAMPLER_HISTORY + frames];
+	float	*table = new float[RESAMPLER_SINC_TABLE];
+	int		*pos   = new int[max_out];
+	double	*mu    = new double[max_out];
+	short	*ref   = new short[max_out * 2];
+	short	*out   = new short[max_out * 2];
+	uint32	seed   = 1;
+
+	// Two tones plus noise, loud enough to exercise the saturation
+	for (int i = 0; i < RESAMPLER_HISTORY + frames; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		double	noise = (double) ((seed >> 16) & 0x7fff) / 0x4000 - 1.0;
+
+		left[i]  = (float) (int) (28000.0 * sin(i * 0.031) + 6000.0 * noise);
+		right[i] = (float) (int) (20000.0 * sin(i * 0.47) + 14000.0 * sin(i * 0.0071) - 3000.0 * noise);
+	}
+
+	printf("Resampler kernels, %s detected, %d input frames x %d passes\n\n", S9xResamplerSIMDName(simd), frames, passes);
+	printf("%-8s %-8s %8s %12s %12s %8s %8s\n", "kernel", "isa", "ratio", "Mframes/s", "speedup", "maxdiff", "diffs");
+
+	for (int k = 0; k < 2; k++)
+	{
+		bool8	sinc = (k == 1);
+
+		for (unsigned r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++)
+		{
+			double	step = ratios[r], frac = 1.0;
+			int		count = 0;
+
+			for (int i = 0; i < frames && count < max_out; i++)
+			{
+				while (frac <= 1.0 && count < max_out)
+				{
+					pos[count] = i;
+					mu[count++] = frac;
+					frac += step;
+				}
+
+				frac -= 1.0;
+			}
+
+			S9xResamplerBuildSinc(table, (step < 1.0 ? 1.0 : 1.0 / step) * 0.92);
+
+			uint64	t0 = S9xProfilerClock();
+			ResamplerRun(RESAMPLER_SIMD_NONE, sinc, passes, left, right, pos, mu, count, table, ref);
+			uint64	scalar = S9xProfilerClock() - t0;
+
+			printf("%-8s %-8s %8.4f %12.2f %12s %8s %8s\n", sinc ? "sinc" : "hermite", "scalar", step,
+				   (double) count * passes * 1000.0 / scalar, "", "", "");
+
+			if (simd == RESAMPLER_SIMD_NONE)
+				continue;
+
+			t0 = S9xProfilerClock();
+			ResamplerRun(simd, sinc, passes, left, right, pos, mu, count, table, out);
+			uint64	vector = S9xProfilerClock() - t0;
+
+			int	maxdiff = 0, diffs = 0;
+
+			for (int i = 0; i < count * 2; i++)
+			{
+				int	d = abs(out[i] - ref[i]);
+
+				if (d)
+					diffs++;
+				if (d > maxdiff)
+					maxdiff = d;
+			}
+
+			printf("%-8s %-8s %8.4f %12.2f %11.2fx %8d %8d\n", sinc ? "sinc" : "hermite", S9xResamplerSIMDName(simd), step,
+				   (double) count * passes * 1000.0 / vector, (double) scalar / vector, maxdiff, diffs);
+		}
+	}
+
+	delete[] left;
+	delete[] right;
+	delete[] table;
+	delete[] pos;
+	delete[] mu;
+	delete[] ref;
+	delete[] out;
+}
+
+// Converts every tile of a random VRAM image, with some blank tiles mixed in.
+// Returns the time taken; the converted tiles and their return codes go to out.
+static uint64 TileConverterRun (int kind, bool8 simd, int passes, uint8 *out, uint8 *ret)
+{
+	static const int	size[TILE_CONVERT_COUNT] = { 16, 32, 64, 16, 32, 16, 32 };
+	int					tiles = 0x10000 / size[kind];
+	uint64				t0 = S9xProfilerClock();
+
+	for (int n = 0; n < passes; n++)
+	{
+		for (int t = 0; t < tiles; t++)
+			ret[t] = S9xConvertTile(kind, simd, out + t * 64, t * size[kind], t & 0x3ff);
+	}
+
+	return (S9xProfilerClock() - t0);
+}
+
+static void TileConverterTest (void)
+{
+	static const char	*names[TILE_CONVERT_COUNT] = { "2bpp", "4bpp", "8bpp", "2bpp odd", "4bpp odd", "2bpp even", "4bpp even" };
+	const char			*simd = S9xTileConverterSIMDName();
+
+	// Hires converters read one tile past the one asked for
+	uint8	*vram = new uint8[0x10000 + 64];
+	uint8	*ref  = new uint8[0x1000 * 64];
+	uint8	*out  = new uint8[0x1000 * 64];
+	uint8	*rref = new uint8[0x1000];
+	uint8	*rout = new uint8[0x1000];
+	uint32	seed  = 1;
+
+	for (int i = 0; i < 0x10000 + 64; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		vram[i] = (i & 0x200) ? (seed >> 16) & 0xff : 0;
+	}
+
+	S9xInitTileRenderer();
+	GFX.VRAM = vram;
+
+	printf("Tile converters, %s detected, 64KB VRAM x %d passes\n\n", simd ? simd : "no SIMD", BENCH_TILE_PASSES);
+	printf("%-10s %-8s %12s %12s %8s\n", "kind", "isa", "Mtiles/s", "speedup", "diffs");
+
+	for (int k = 0; k < TILE_CONVERT_COUNT; k++)
+	{
+		int		tiles = (k == TILE_CONVERT_8) ? 0x400 : (k == TILE_CONVERT_4 || k == TILE_CONVERT_4H_ODD || k == TILE_CONVERT_4H_EVEN) ? 0x800 : 0x1000;
+		uint64	scalar = TileConverterRun(k, FALSE, BENCH_TILE_PASSES, ref, rref);
+
+		printf("%-10s %-8s %12.2f %12s %8s\n", names[k], "scalar", (double) tiles * BENCH_TILE_PASSES * 1000.0 / scalar, "", "");
+
+		if (!simd)
+			continue;
+
+		uint64	vector = TileConverterRun(k, TRUE, BENCH_TILE_PASSES, out, rout);
+		int		diffs = 0;
+
+		for (int t = 0; t < tiles; t++)
+		{
+			if (rout[t] != rref[t] || memcmp(out + t * 64, ref + t * 64, 64))
+				diffs++;
+		}
+
+		printf("%-10s %-8s %12.2f %11.2fx %8d\n", names[k], simd, (double) tiles * BENCH_TILE_PASSES * 1000.0 / vector, (double) scalar / vector, diffs);
+	}
+
+	GFX.VRAM = NULL;
+
+	delete[] vram;
+	delete[] ref;
+	delete[] out;
+	delete[] rref;
+	delete[] rout;
+}
+
+// A scrolling tiled background with a few moving blocks, a gradient panel
+// and a strip of noise, so the filters see flat areas, hard edges, ramps,
+// motion and every neighbour pattern.
+static void FilterFrame (uint16 *screen, int ppl, int frame)
+{
+	static const uint16	colours[8] = { 0x0000, 0xffff, 0xf800, 0x07e0, 0x001f, 0x8410, 0xfd20, 0x4208 };
+
+	for (int y = 0; y < SNES_HEIGHT; y++)
+	{
+		uint16	*p = screen + y * ppl;
+
+		for (int x = 0; x < SNES_WIDTH; x++)
+		{
+			int	tx = (x + frame) >> 3, ty = y >> 3;
+
+			p[x] = colours[(tx ^ ty ^ ((tx * ty) >> 2)) & 3];
+
+			if (y >= 160 && x < 128)
+				p[x] = BUILD_PIXEL(x >> 2, (y - 160) >> 1, (x + y + frame) & 31);
+
+			if (y >= 96 && y < 104)
+				p[x] = (uint16) (((x * 2654435761u) ^ (y * 40503u) ^ (frame * 97u)) >> 7);
+		}
+	}
+
+	for (int b = 0; b < 8; b++)
+	{
+		int	bx = (b * 37 + frame * (b + 1)) % (SNES_WIDTH - 16), by = (b * 23 + frame * 2) % (SNES_HEIGHT - 16);
+
+		for (int y = 0; y < 16; y++)
+		{
+			for (int x = 0; x < 16; x++)
+			{
+				if ((x - 8) * (x - 8) + (y - 8) * (y - 8) < 50)
+					screen[(by + y) * ppl + bx + x] = colours[4 + (b & 3)];
+			}
+		}
+	}
+}
+
+// Runs one filter over BENCH_FILTER_FRAMES frames from a clean screen and
+// delta buffer, hashing the output after each. Returns the nanoseconds spent
+// in the filter itself, best of BENCH_FILTER_RUNS runs. With threaded, the
+// frames go through the filter thread pool.
+static uint64 FilterRun (Blitter filter, bool8 simd, bool8 threaded, uint8 *src, uint8 *dst, uint32 *hashes)
+{
+	int		pitch = SNES_WIDTH * 2 * 2, dpitch = SNES_WIDTH * 3 * 2;
+	uint64	best = 0;
+
+	S9xBlitSetSIMD(simd);
+
+	for (int r = 0; r < BENCH_FILTER_RUNS; r++)
+	{
+		uint64	total = 0;
+
+		S9xBlitClearDelta();
+		memset(dst, 0, dpitch * SNES_HEIGHT_EXTENDED * 2);
+
+		for (int f = 0; f < BENCH_FILTER_FRAMES; f++)
+		{
+			FilterFrame((uint16 *) src, pitch >> 1, f);
+
+			uint64	t0 = S9xProfilerClock();
+			if (threaded)
+				S9xBlitThreaded(filter, src, pitch, dst, dpitch, SNES_WIDTH, SNES_HEIGHT);
+			else
+				filter(src, pitch, dst, dpitch, SNES_WIDTH, SNES_HEIGHT);
+			total += S9xProfilerClock() - t0;
+
+			hashes[f] = HashBytes(2166136261u, dst, dpitch * SNES_HEIGHT * 2);
+		}
+
+		if (!r || total < best)
+			best = total;
+	}
+
+	S9xBlitSetSIMD(TRUE);
+
+	return (best);
+}
+
+static int FilterDiffs (const uint32 *ref, const uint32 *out)
+{
+	int	diffs = 0;
+
+	for (int f = 0; f < BENCH_FILTER_FRAMES; f++)
+	{
+		if (out[f] != ref[f])
+			diffs++;
+	}
+
+	return (diffs);
+}
+
+static void FilterTest (void)
+{
+	static const struct
+	{
+		const char	*name;
+		Blitter		filter;
+		bool8		simd;
+	}	filters[] =
+	{
+		{ "blocky",     S9xBlitPixSimple2x2,    TRUE  },
+		{ "tv",         S9xBlitPixTV2x2,        TRUE  },
+		{ "smooth",     S9xBlitPixSmooth2x2,    FALSE },
+		{ "supereagle", S9xBlitPixSuperEagle16, FALSE },
+		{ "2xsai",      S9xBlitPix2xSaI16,      FALSE },
+		{ "super2xsai", S9xBlitPixSuper2xSaI16, FALSE },
+		{ "epx",        S9xBlitPixEPX16,        TRUE  },
+		{ "hq2x",       S9xBlitPixHQ2x16,       FALSE },
+		{ "ntsc",       S9xBlitPixNTSC16,       TRUE  },
+		{ "ntschires",  S9xBlitPixHiResNTSC16,  TRUE  }
+	};
+
+	const char	*simd = S9xBlitSIMDName();
+
+#ifdef GFX_MULTI_FORMAT
+	S9xSetRenderPixelFormat(RGB565);
+#endif
+	if (!S9xBlitFilterInit() || !S9xBlit2xSaIFilterInit() || !S9xBlitHQ2xFilterInit() || !S9xBlitNTSCFilterInit())
+	{
+		fprintf(stderr, "Failed to initialise the filters.\n");
+		exit(1);
+	}
+
+	if (bench_blit_threads > 1 && !S9xInitBlitThreads(bench_blit_threads))
+	{
+		fprintf(stderr, "Failed to start the filter threads.\n");
+		exit(1);
+	}
+
+	// Same layout as the screen buffer; the filters read a line either side
+	int		pitch = SNES_WIDTH * 2 * 2;
+	uint8	*buffer = (uint8 *) calloc(pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
+	uint8	*dst = (uint8 *) calloc(SNES_WIDTH * 3 * 2 * SNES_HEIGHT_EXTENDED * 2, 1);
+	uint32	ref[BENCH_FILTER_FRAMES], out[BENCH_FILTER_FRAMES];
+	char	threads[16];
+
+	sprintf(threads, "%d thr", S9xBlitThreadCount());
+
+	printf("Scaling filters, %s detected, %dx%d x %d frames\n\n", simd ? simd : "no SIMD", SNES_WIDTH, SNES_HEIGHT, BENCH_FILTER_FRAMES);
+	printf("%-10s %-8s %12s %12s %8s\n", "filter", "isa", "ms/frame", "speedup", "diffs");
+
+	for (unsigned int k = 0; k < sizeof(filters) / sizeof(filters[0]); k++)
+	{
+		uint64	scalar = FilterRun(filters[k].filter, FALSE, FALSE, buffer + pitch * 4, dst, ref);
+		uint64	single = scalar;
+		bool8	vector = simd && filters[k].simd;
+
+		printf("%-10s %-8s %12.3f %12s %8s\n", filters[k].name, "scalar", scalar / 1e6 / BENCH_FILTER_FRAMES, "", "");
+
+		if (vector)
+		{
+			single = FilterRun(filters[k].filter, TRUE, FALSE, buffer + pitch * 4, dst, out);
+			printf("%-10s %-8s %12.3f %11.2fx %8d\n", filters[k].name, simd, single / 1e6 / BENCH_FILTER_FRAMES, (double) scalar / single, FilterDiffs(ref, out));
+		}
+
+		// The bands use the fastest single thread code, and are timed against it
+		if (S9xBlitThreadCount() > 1)
+		{
+			uint64	banded = FilterRun(filters[k].filter, vector, TRUE, buffer + pitch * 4, dst, out);
+			printf("%-10s %-8s %12.3f %11.2fx %8d\n", filters[k].name, threads, banded / 1e6 / BENCH_FILTER_FRAMES, (double) single / banded, FilterDiffs(ref, out));
+		}
+	}
+
+	S9xDeinitBlitThreads();
+	S9xBlitNTSCFilterDeinit();
+	S9xBlitHQ2xFilterDeinit();
+	S9xBlit2xSaIFilterDeinit();
+	S9xBlitFilterDeinit();
+
+	free(buffer);
+	free(dst);
+}
+
+// Loads the ROM afresh and checksums bench_frames frames of it.
+static void ChecksumRun (const char *rom_filename, uint32 *video, uint32 *audio)
+{
+	Settings.StopEmulation = TRUE;
+
+	if (!Memory.LoadROM(rom_filename))
+	{
+		fprintf(stderr, "Error opening the ROM file.\n");
+		exit(1);
+	}
+
+	S9xSetController(0, CTL_JOYPAD, 0, 0, 0, 0);
+	S9xSetController(1, CTL_NONE,   0, 0, 0, 0);
+
+	bench_checksum = TRUE;
+	video_checksum = audio_checksum = 2166136261u;
+	Settings.StopEmulation = FALSE;
+
+	for (int i = 0; i < bench_frames; i++)
+		S9xMainLoop();
+
+	*video = video_checksum;
+	*audio = audio_checksum;
+}
+
+static bool8 ChecksumCompare (const char *title, int runs, const char **names, const uint32 *video, const uint32 *audio)
+{
+	printf("%s, %d frames\n\n", title, bench_frames);
+	printf("%-10s %8s %8s\n", "run", "video", "audio");
+
+	bool8	match = TRUE;
+
+	for (int k = 0; k < runs; k++)
+	{
+		printf("%-10s %08x %08x\n", names[k], video[k], audio[k]);
+		if (video[k] != video[0] || audio[k] != audio[0])
+			match = FALSE;
+	}
+
+	printf("\n%s\n", match ? "checksums match" : "checksums differ");
+
+	return (match);
+}
+
+static bool8 SA1BatchTest (const char *rom_filename)
+{
+	// The map is built for one mode or the other, so the ROM is loaded again for each run
+	const char	*names[2] = { "per opcode", "batched" };
+	uint32		video[2], audio[2];
+
+	for (int k = 0; k < 2; k++)
+	{
+		Settings.SA1Batch = k;
+		ChecksumRun(rom_filename, &video[k], &audio[k]);
+
+		if (!Settings.SA1)
+		{
+			fprintf(stderr, "-sa1test needs an SA-1 ROM.\n");
+			exit(1);
+		}
+	}
+
+	return (ChecksumCompare("SA1 batching", 2, names, video, audio));
+}
+
+static bool8 RenderTest (const char *rom_filename)
+{
+	// The second vector run stores as it would into video memory, never reading the screen back
+	const char	*names[3] = { S9xTileConverterSIMDName(), "uncached", "scalar" };
+	uint32		video[3], audio[3];
+
+	if (!names[0])
+	{
+		fprintf(stderr, "-rendertest needs a build with SSE2 or NEON.\n");
+		exit(1);
+	}
+
+	for (int k = 0; k < 3; k++)
+	{
+		S9xSetTileSIMD(k < 2);
+		S9xSetTileScreenUncached(k == 1);
+		ChecksumRun(rom_filename, &video[k], &audio[k]);
+	}
+
+	S9xSetTileSIMD(TRUE);
+	S9xSetTileScreenUncached(FALSE);
+
+	return (ChecksumCompare("Tile renderers", 3, names, video, audio));
+}
+
+int main (int argc, char **argv)
+{
+	if (argc < 2)
+		S9xUsage();
+
+	ZeroMemory(&Settings, sizeof(Settings));
+	Settings.FrameTimePAL = 20000;
+	Settings.FrameTimeNTSC = 16667;
+	Settings.SixteenBitSound = TRUE;
+	Settings.Stereo = TRUE;
+	Settings.SoundPlaybackRate = 32000;
+	Settings.SoundInputRate = 32000;
+	Settings.DynamicRateLimit = 5;
+	Settings.SupportHiRes = TRUE;
+	Settings.Transparency = TRUE;
+	Settings.HDMATimingHack = 100;
+	Settings.BlockInvalidVRAMAccessMaster = TRUE;
+	Settings.StopEmulation = TRUE;
+	Settings.SkipFrames = 1;
+
+	CPU.Flags = 0;
+
+	const char	*rom_filename = S9xParseArgs(argv, argc);
+
+	if (bench_resampler)
+	{
+		ResamplerTest();
+		return (0);
+	}
+
+	if (bench_tiles)
+	{
+		TileConverterTest();
+		return (0);
+	}
+
+	if (bench_filters)
+	{
+		FilterTest();
+		return (0);
+	}
+
+	if (!rom_filename)
+		S9xUsage();
+
+	if (Settings.SkipFrames == AUTO_FRAMERATE)
+		Settings.SkipFrames = 1;
+
+	if (!Memory.Init() || !S9xInitAPU())
+	{
+		fprintf(stderr, "Snes9x: Memory allocation failure - not enough RAM/virtual memory available.\nExiting...\n");
+		Memory.Deinit();
+		S9xDeinitAPU();
+		exit(1);
+	}
+
+	S9xInitSound(100, 0);
+	S9xSetSoundMute(FALSE);
+
+#ifdef GFX_MULTI_FORMAT
+	S9xSetRenderPixelFormat(RGB565);
+#endif
+
+	// Same layout as the SDL port so the renderers see an identical pitch.
+	GFX.Pitch = SNES_WIDTH * 2 * 2;
+	screen_buffer = (uint8 *) calloc(GFX.Pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
+	if (!screen_buffer)
+	{
+		fprintf(stderr, "Failed to allocate the screen buffer.\n");
+		exit(1);
+	}
+
+	GFX.Screen = (uint16 *) (screen_buffer + (GFX.Pitch * 2 * 2));
+	S9xGraphicsInit();
+
+	if (bench_sa1 || bench_render)
+	{
+		if (!(bench_sa1 ? SA1BatchTest(rom_filename) : RenderTest(rom_filename)))
+			exit(1);
+
+		free(screen_buffer);
+		S9xExit();
+	}
+
+	if (!Memory.LoadROM(rom_filename))
+	{
+		fprintf(stderr, "Error opening the ROM file.\n");
+		exit(1);
+	}
+
+	S9xSetController(0, CTL_JOYPAD, 0, 0, 0, 0);
+	S9xSetController(1, CTL_NONE,   0, 0, 0, 0);
+
+	Settings.StopEmulation = FALSE;
+
+	for (int i = 0; i < bench_warmup; i++)
+		S9xMainLoop();
+
+	S9xProfilerReset();
+	S9xProfilerStart(PROF_MASK_ALL);
+
+	uint64	start = S9xProfilerClock();
+
+	for (int i = 0; i < bench_frames; i++)
+		S9xMainLoop();
+
+	uint64	elapsed = S9xProfilerClock() - start;
+
+	S9xProfilerStop();
+
+	PrintReport(elapsed, bench_frames > 0 ? bench_frames : 1);
+
+	free(screen_buffer);
+	S9xExit();
+
+	return (0);
+}
@@ -5,6 +5,9 @@
 typedef std::pair<std::string, std::string>	strpair_t;
 extern ConfigFile::secvec_t	keymaps;
 
+void S9xWaitForSoundDrain (void);
+bool8 S9xBeginImage (void);
+
 
 
 
@@ -71,6 +71,7 @@
 SDL_AudioSpec *audiospec;
 uint32        sound_buffer_size;
 static Uint8 mixed_buffer[16384];
+static SDL_sem *audio_drained = NULL;
 
 void S9xToggleSoundChannel (int c)
 {
@@ -84,14 +85,19 @@ void S9xToggleSoundChannel (int c)
 	S9xSetSoundControl(sound_switch);
 }
 
+/* The resampler ring is single-producer/single-consumer, so neither side
+   takes the audio lock: the callback only consumes and the emulator only
+   produces. The callback posts audio_drained so a SoundSync wait sleeps
+   until there is room instead of spinning. */
 static void
 sdl_audio_callback (void *userdata, Uint8 *stream, int len)
 {
-    SDL_LockAudio ();
     //S9xMixSamples (stream, len >> (Settings.SixteenBitSound ? 1 : 0));
     S9xMixSamples (mixed_buffer, len >> 1);
     SDL_MixAudio(stream, mixed_buffer, len, currentVolume);
-    SDL_UnlockAudio ();
+
+    if (audio_drained && SDL_SemValue (audio_drained) == 0)
+        SDL_SemPost (audio_drained);
 
     return;
 }
@@ -99,13 +105,17 @@ sdl_audio_callback (void *userdata, Uint8 *stream, int len)
 static void
 samples_available (void *data)
 {
-    SDL_LockAudio ();
     S9xFinalizeSamples ();
-    SDL_UnlockAudio ();
 
     return;
 }
 
+void S9xWaitForSoundDrain (void)
+{
+	if (!audio_drained || SDL_SemWaitTimeout (audio_drained, 10) == -1)
+		usleep(1000);
+}
+
 bool8 S9xOpenSoundDevice (void)
 {
 #ifdef HAVE_SDL
@@ -136,6 +146,9 @@ bool8 S9xOpenSoundDevice (void)
 	
 	printf ("OK\n");
 	
+	if (!audio_drained)
+		audio_drained = SDL_CreateSemaphore (0);
+
 	SDL_PauseAudio (0);
 	
 	S9xSetSamplesAvailableCallback (samples_available, NULL);
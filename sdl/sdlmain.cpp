@@ -61,6 +61,7 @@
 #include "logger.h"
 #include "display.h"
 #include "conffile.h"
+#include "profiler.h"
 #ifdef NETPLAY_SUPPORT
 #include "netplay.h"
 #endif
@@ -76,11 +77,12 @@
 
 #include "gui.h" /* AWH: BeagleSNES GUI */
 
-static const char	*s9x_base_dir        = NULL,
-					*rom_filename        = NULL,
-					*snapshot_filename   = NULL,
-					*play_smv_filename   = NULL,
-					*record_smv_filename = NULL;
+static const char	*s9x_base_dir         = NULL,
+					*rom_filename         = NULL,
+					*snapshot_filename    = NULL,
+					*play_smv_filename    = NULL,
+					*record_smv_filename  = NULL,
+					*profile_csv_filename = NULL;
 
 extern uint32           sound_buffer_size; // used in sdlaudio
 
@@ -202,6 +204,8 @@ void S9xExtraUsage (void) // domaemon: ExtraUsage -> ExtraDisplayUsage
 	S9xMessage(S9X_INFO, S9X_USAGE, "-dumpstreams                    Save audio/video data to disk");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-dumpmaxframes <num>            Stop emulator after saving specified number of");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                frames (use with -dumpstreams)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-profilecsv <filename>          Write per-frame timings of the last 600 frames");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                on exit");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	S9xExtraDisplayUsage();
@@ -268,6 +272,14 @@ void S9xParseArg (char **argv, int &i, int argc)
 	else
 	if (!strcasecmp(argv[i], "-dumpmaxframes"))
 		Settings.DumpStreamsMaxFrames = atoi(argv[++i]);
+	else
+	if (!strcasecmp(argv[i], "-profilecsv"))
+	{
+		if (i + 1 < argc)
+			profile_csv_filename = argv[++i];
+		else
+			S9xUsage();
+	}
 	else
 		S9xParseDisplayArg(argv, i, argc);
 }
@@ -369,6 +381,7 @@ void S9xParsePortConfig (ConfigFile &conf, int pass)
 	snapshot_filename           = conf.GetStringDup("Unix::SnapshotFilename",    NULL);
 	play_smv_filename           = conf.GetStringDup("Unix::PlayMovieFilename",   NULL);
 	record_smv_filename         = conf.GetStringDup("Unix::RecordMovieFilename", NULL);
+	profile_csv_filename        = conf.GetStringDup("Unix::ProfileCSV",          NULL);
 	sound_buffer_size           = conf.GetUInt     ("Unix::SoundBufferSize",     100);
 	// domaemon: default input configuration
 	S9xParseInputConfig(conf, 1);
@@ -587,7 +600,7 @@ void S9xCloseSnapshotFile (STREAM file)
 
 bool8 S9xInitUpdate (void)
 {
-	return (TRUE);
+	return (S9xBeginImage());
 }
 
 bool8 S9xDeinitUpdate (int width, int height)
@@ -609,10 +622,12 @@ void S9xAutoSaveSRAM (void)
 void S9xSyncSpeed (void)
 {
   // doemaemon: not sure how crucial this is atm.
-	if (Settings.SoundSync)
+	// Dynamic rate control paces frames off the timer below and lets the
+	// resampler absorb the drift, so it never waits on the sound device.
+	if (Settings.SoundSync && !Settings.DynamicRateControl)
 	{
 		while (!S9xSyncSound())
-			usleep(0);
+			S9xWaitForSoundDrain();
 	}
 
 	if (Settings.DumpStreams)
@@ -760,6 +775,8 @@ void S9xExit (void)
 #endif
 
 	Memory.SaveSRAM(S9xGetFilename(".srm", SRAM_DIR));
+	if (profile_csv_filename)
+		S9xProfilerDumpCSV(profile_csv_filename);
 	// AWH S9xSaveCheatFile(S9xGetFilename(".cht", CHEAT_DIR));
 	S9xResetSaveTimer(FALSE);
 
@@ -1023,6 +1040,9 @@ fprintf(stderr, "AWH: ROM: '%s'\n", s);
 #endif // BeagleSNES
 	S9xSetSoundMute(FALSE);
 
+	S9xProfilerReset();
+	S9xProfilerStart((Settings.DisplayProfiler || profile_csv_filename) ? PROF_MASK_DETAIL : PROF_MASK_FRAME);
+
 #ifdef NETPLAY_SUPPORT
 	bool8	NP_Activated = Settings.NetPlay;
 #endif
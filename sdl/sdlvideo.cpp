@@ -36,9 +36,16 @@
 #include <ctype.h>
 #include <errno.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
 #ifdef HAVE_STRINGS_H
 #include <strings.h>
 #endif
+#ifdef __linux
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/fb.h>
+#endif
 
 #include "snes9x.h"
 #include "memmap.h"
@@ -48,7 +55,9 @@
 #include "logger.h"
 #include "conffile.h"
 #include "blit.h"
+#include "blitthread.h"
 #include "display.h"
+#include "tile.h"
 
 #include "sdl_snes9x.h"
 
@@ -61,11 +70,54 @@ struct GUIData
 	uint8			*blit_screen;
 	uint32			blit_screen_pitch;
 	int			video_mode;
+	int			blit_threads;	// threads drawing the scaled image in bands
         bool8                   fullscreen;
+	bool8			direct;		// GFX.Screen points into sdl_screen
+	bool8			locked;
+	bool8			overlay;	// volume bars were drawn over the last frame
 };
 static struct GUIData	GUI;
 
-typedef	void (* Blitter) (uint8 *, int, uint8 *, int, int, int);
+// With Present.Enabled a thread of its own copies finished frames to the
+// screen, so a slow display never holds up emulation or sound. Three buffers
+// rotate between the two threads: the emulator draws into Render, the newest
+// finished frame waits in Ready (-1 when there is none) and the presenter
+// copies out of Shown. Neither side ever waits for the other. A frame still
+// in Ready when the next one is finished is dropped, and a vblank with
+// nothing new in Ready leaves the last frame on screen.
+static struct
+{
+	bool8			Enabled;
+	bool8			Running;
+	volatile bool8	Quit;
+	pthread_t		Thread;
+	pthread_mutex_t	Lock;
+	uint8			*Buffer[3];
+	int				Pitch;				// GFX is per thread
+	int				Render, Ready, Shown;
+	int				Width[3], Height[3];
+	uint64			Finished[3];		// microseconds
+	int				VSyncFD;
+	uint64			NextVBlank;			// microseconds, when timed
+
+	uint32			Presented;
+	uint32			Dropped;
+	uint32			Repeated;
+	uint64			LatencyTotal;		// microseconds, finish to screen
+	uint32			LatencyMax;
+}	Present;
+
+// Only the screen rows whose source changed since the last frame copied out
+// are pushed to the display, in one SDL_UpdateRects() call. Last keeps that
+// frame, one SNES_WIDTH * 2 pixel row per source line.
+static struct
+{
+	uint8			*Last;
+	bool8			Valid;				// Last can be compared against
+	int				Width, Height;		// of the frame in Last
+	uint32			Frames;
+	uint32			Rows;				// screen rows pushed, all frames
+}	Update;
 
 #ifdef __linux
 // Select seems to be broken in 2.x.x kernels - if a signal interrupts a
@@ -95,14 +147,24 @@ enum
 static void SetupImage (void);
 static void TakedownImage (void);
 static void Repaint (bool8);
+static void CopyImage (uint8 *, int, int, int);
+static void ChangedRows (uint8 *, int, int, int, bool8 *);
+static void UpdateRows (const bool8 *, int, int, int, int);
+static uint64 PresentClock (void);
+static void PresentWaitVBlank (void);
+static void * PresentThread (void *);
+static void StartPresentThread (void);
+static void StopPresentThread (void);
 
 void S9xExtraDisplayUsage (void)
 {
 	S9xMessage(S9X_INFO, S9X_USAGE, "-fullscreen                     fullscreen mode (without scaling)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-presentthread                  Copy frames to the screen from a thread of their own");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-blitthreads <num>               Scale each frame on <num> threads (default 1)");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
-	S9xMessage(S9X_INFO, S9X_USAGE, "-v1                             Video mode: Blocky (default)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-v1                             Video mode: Blocky");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v2                             Video mode: TV");
-	S9xMessage(S9X_INFO, S9X_USAGE, "-v3                             Video mode: Smooth");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-v3                             Video mode: Smooth (default)");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v4                             Video mode: SuperEagle");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v5                             Video mode: 2xSaI");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-v6                             Video mode: Super2xSaI");
@@ -119,6 +181,17 @@ void S9xParseDisplayArg (char **argv, int &i, int argc)
                 printf ("Entering fullscreen mode (without scaling).\n");
         }
         else
+	if (!strcasecmp(argv[i], "-presentthread"))
+		Present.Enabled = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-blitthreads"))
+	{
+		if (i + 1 < argc)
+			GUI.blit_threads = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
 	if (!strncasecmp(argv[i], "-v", 2))
 	{
 		switch (argv[i][2])
@@ -147,12 +220,15 @@ const char * S9xParseDisplayConfig (ConfigFile &conf, int pass)
 #endif // AWH
 	if (conf.Exists("Unix/SDL::VideoMode"))
 	{
-		GUI.video_mode = conf.GetUInt("Unix/SDL::VideoMode", VIDEOMODE_BLOCKY);
+		GUI.video_mode = conf.GetUInt("Unix/SDL::VideoMode", VIDEOMODE_SMOOTH);
 		if (GUI.video_mode < 1 || GUI.video_mode > 8)
-			GUI.video_mode = VIDEOMODE_BLOCKY;
+			GUI.video_mode = VIDEOMODE_SMOOTH;
 	}
 	else
-		GUI.video_mode = VIDEOMODE_BLOCKY;
+		GUI.video_mode = VIDEOMODE_SMOOTH;
+
+	Present.Enabled = conf.GetBool("Unix/SDL::PresentThread", false);
+	GUI.blit_threads = conf.GetInt("Unix/SDL::BlitThreads", 1);
 #if 0 // AWH - BeagleSNES
 	return ("Unix/SDL");
 #else
@@ -182,13 +258,18 @@ void S9xInitDisplay (int argc, char **argv)
 	 * we just go along with RGB565 for now, nothing else..
 	 */
 	
+#ifdef GFX_MULTI_FORMAT
 	S9xSetRenderPixelFormat(RGB565);
+#endif
 	
 	S9xBlitFilterInit();
-#if 0 // AWH
+#if !defined(CAPE_LCD3)
 	S9xBlit2xSaIFilterInit();
 	S9xBlitHQ2xFilterInit();
-#endif // AWH
+
+	if (GUI.blit_threads > 1 && !S9xInitBlitThreads(GUI.blit_threads))
+		fprintf(stderr, "Unable to start the filter threads, scaling on one.\n");
+#endif
 
 	/*
 	 * domaemon
@@ -196,6 +277,19 @@ void S9xInitDisplay (int argc, char **argv)
 	 * FIXME: The secreen size should be flexible
 	 * FIXME: Check if the SDL screen is really in RGB565 mode. screen->fmt	
 	 */	
+	// SDL 1.2 video is not thread-safe; only fbcon, where the screen is the
+	// mapped framebuffer, can be written and updated from a second thread.
+	if (Present.Enabled)
+	{
+		char	driver[16];
+
+		if (!SDL_VideoDriverName(driver, sizeof(driver)) || strcmp(driver, "fbcon"))
+		{
+			fprintf(stderr, "The present thread needs the fbcon video driver, copying frames on the emulation thread.\n");
+			Present.Enabled = FALSE;
+		}
+	}
+
         if (GUI.fullscreen == TRUE)
         {
                 GUI.sdl_screen = SDL_SetVideoMode(0, 0, 16, SDL_FULLSCREEN);
@@ -203,7 +297,8 @@ void S9xInitDisplay (int argc, char **argv)
                 /* AWH - Modified */
                 // NTSC GUI.sdl_screen = SDL_SetVideoMode(512 + 104, 478, 16, 0);
 #if defined(CAPE_LCD3)
-GUI.sdl_screen = SDL_SetVideoMode(320, 240, 16, 0);
+// The presenter waits for vblank itself and copies into a single buffer
+GUI.sdl_screen = SDL_SetVideoMode(320, 240, 16, Present.Enabled ? 0 : SDL_HWSURFACE | SDL_DOUBLEBUF);
 #else
 		GUI.sdl_screen = SDL_SetVideoMode(640, 480, 16, 0);
 #endif
@@ -222,19 +317,27 @@ fprintf(stderr, "screen %dx%d, pitch: %d\n", GUI.sdl_screen->w, GUI.sdl_screen->
 	 * buffer allocation, quite important
 	 */
 	SetupImage();
+
+	if (Present.Enabled)
+		StartPresentThread();
 }
 
 void S9xDeinitDisplay (void)
 {
+	StopPresentThread();
 	TakedownImage();
 
+	if (Update.Frames)
+		fprintf(stderr, "update: %u frames, %u rows per frame avg\n", Update.Frames, Update.Rows / Update.Frames);
+
 	SDL_Quit();
 
 	S9xBlitFilterDeinit();
-#if 0 // AWH
+#if !defined(CAPE_LCD3)
+	S9xDeinitBlitThreads();
 	S9xBlit2xSaIFilterDeinit();
 	S9xBlitHQ2xFilterDeinit();
-#endif // AWH
+#endif
 }
 
 static void TakedownImage (void)
@@ -245,6 +348,23 @@ static void TakedownImage (void)
 		GUI.snes_buffer = NULL;
 	}
 
+	if (Update.Last)
+	{
+		free(Update.Last);
+		Update.Last = NULL;
+	}
+	Update.Valid = FALSE;
+
+	Present.Buffer[0] = NULL;
+	for (int i = 1; i < 3; i++)
+	{
+		if (Present.Buffer[i])
+		{
+			free(Present.Buffer[i]);
+			Present.Buffer[i] = NULL;
+		}
+	}
+
 	S9xGraphicsDeinit();
 }
 
@@ -252,6 +372,38 @@ static void SetupImage (void)
 {
 	TakedownImage();
 
+#if defined(CAPE_LCD3)
+	// The panel shows the SNES frame 1:1, so the core draws straight into the
+	// SDL surface and S9xPutImage() only has to flip it. Every line has to fit
+	// the surface for that, which rules out 512-pixel hi-res lines.
+	GUI.direct = !Present.Enabled && !GUI.fullscreen && GUI.sdl_screen->format->BitsPerPixel == 16 &&
+		GUI.sdl_screen->w >= SNES_WIDTH && GUI.sdl_screen->h >= SNES_HEIGHT_EXTENDED;
+	// A hardware surface is the mapped framebuffer, which the renderers must not read back
+	S9xSetTileScreenUncached(GUI.direct && (GUI.sdl_screen->flags & SDL_HWSURFACE));
+	if (GUI.direct)
+	{
+		Settings.SupportHiRes = FALSE;
+		// Each page still holds the frame before last, so no line can be reused.
+		if (GUI.sdl_screen->flags & SDL_DOUBLEBUF)
+			Settings.SkipUnchangedLines = FALSE;
+
+		for (int i = 0; i < 2; i++)
+		{
+			if (SDL_MUSTLOCK(GUI.sdl_screen))
+				SDL_LockSurface(GUI.sdl_screen);
+			memset(GUI.sdl_screen->pixels, 0, GUI.sdl_screen->pitch * GUI.sdl_screen->h);
+			if (SDL_MUSTLOCK(GUI.sdl_screen))
+				SDL_UnlockSurface(GUI.sdl_screen);
+			SDL_Flip(GUI.sdl_screen);
+		}
+
+		GFX.Pitch = GUI.sdl_screen->pitch;
+		GFX.Screen = NULL;
+		S9xGraphicsInit();
+		return;
+	}
+#endif
+
 	// domaemon: The whole unix code basically assumes output=(original * 2);
 	// This way the code can handle the SNES filters, which does the 2X.
 	GFX.Pitch = SNES_WIDTH * 2 * 2;
@@ -262,6 +414,30 @@ static void SetupImage (void)
 	// domaemon: Add 2 lines before drawing.
 	GFX.Screen = (uint16 *) (GUI.snes_buffer + (GFX.Pitch * 2 * 2));
 
+	Update.Last = (uint8 *) malloc(SNES_WIDTH * 2 * 2 * SNES_HEIGHT_EXTENDED * 2);
+	if (!Update.Last)
+		FatalError("Failed to allocate the update buffer.");
+
+	if (Present.Enabled)
+	{
+		// The first one is GUI.snes_buffer
+		Present.Buffer[0] = GUI.snes_buffer;
+		for (int i = 1; i < 3; i++)
+		{
+			Present.Buffer[i] = (uint8 *) calloc(GFX.Pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
+			if (!Present.Buffer[i])
+				FatalError("Failed to allocate the present buffers.");
+		}
+
+		Present.Pitch  = GFX.Pitch;
+		Present.Render = 0;
+		Present.Ready  = -1;
+		Present.Shown  = 2;
+
+		// The buffer drawn into changes every frame, so no line can be reused
+		Settings.SkipUnchangedLines = FALSE;
+	}
+
 	if (GUI.fullscreen == TRUE)
 	{
 fprintf(stderr, "Using fullscreen mode\n");
@@ -295,33 +471,134 @@ fprintf(stderr, "Using fullscreen mode\n");
 	S9xGraphicsInit();
 }
 
+// Called at the start of each rendered frame. In direct mode this points
+// GFX.Screen at the page the frame is about to be drawn into, centred
+// horizontally and one row down so that a 239-line frame still fits.
+bool8 S9xBeginImage (void)
+{
+	if (Present.Enabled)
+	{
+		GFX.Screen = (uint16 *) (Present.Buffer[Present.Render] + (GFX.Pitch * 2 * 2));
+		return (TRUE);
+	}
+
+#if defined(CAPE_LCD3)
+	if (!GUI.direct)
+		return (TRUE);
+
+	if (!GUI.locked)
+	{
+		if (SDL_MUSTLOCK(GUI.sdl_screen) && SDL_LockSurface(GUI.sdl_screen) < 0)
+			return (FALSE);
+		GUI.locked = TRUE;
+	}
+
+	int	top  = (GUI.sdl_screen->h - SNES_HEIGHT_EXTENDED + 1) / 2;
+	int	left = (GUI.sdl_screen->w - SNES_WIDTH) / 2;
+
+	GFX.Screen = (uint16 *) ((uint8 *) GUI.sdl_screen->pixels + top * GUI.sdl_screen->pitch + left * 2);
+
+	// The volume bars are drawn over the rows the next frame may want to reuse
+	if (GUI.overlay)
+	{
+		S9xInvalidateLines(170 - top, 170 + 30 - top);
+		GUI.overlay = FALSE;
+	}
+#endif
+
+	return (TRUE);
+}
+
 void S9xPutImage (int width, int height)
 {
-	static int	prevWidth = 0, prevHeight = 0;
-	int			copyWidth, copyHeight;
+#if defined(CAPE_LCD3)
+	if (GUI.direct)
+	{
+		if (GUI.locked)
+		{
+			if (SDL_MUSTLOCK(GUI.sdl_screen))
+				SDL_UnlockSurface(GUI.sdl_screen);
+			GUI.locked = FALSE;
+		}
+
+		GUI.overlay = volumeOverlayCount > 0;
+		renderVolume(GUI.sdl_screen);
+		SDL_Flip(GUI.sdl_screen);
+		return;
+	}
+#endif
+
+	if (Present.Enabled)
+	{
+		pthread_mutex_lock(&Present.Lock);
+
+		int	done = Present.Render;
+		Present.Width[done]    = width;
+		Present.Height[done]   = height;
+		Present.Finished[done] = PresentClock();
+
+		if (Present.Ready >= 0)
+		{
+			// The presenter has not taken the last one yet: replace it
+			Present.Render = Present.Ready;
+			Present.Dropped++;
+		}
+		else
+			Present.Render = 3 - done - Present.Shown;
+		Present.Ready = done;
+
+		pthread_mutex_unlock(&Present.Lock);
+
+		GFX.Screen = (uint16 *) (Present.Buffer[Present.Render] + (GFX.Pitch * 2 * 2));
+		return;
+	}
+
+	CopyImage((uint8 *) GFX.Screen, GFX.Pitch, width, height);
+}
+
+static void CopyImage (uint8 *src, int pitch, int width, int height)
+{
+	bool8	changed[SNES_HEIGHT_EXTENDED * 2];
+
+#if defined(CAPE_LCD3)
+	S9xBlitPixSimple1x1(src, pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
+	ChangedRows(src, pitch, width, height, changed);
+
+	// The volume bars, and the frame under them once they go away
+	bool8	overlay = volumeOverlayCount > 0;
+	int		top = (GUI.blit_screen - (uint8 *) GUI.sdl_screen->pixels) / GUI.sdl_screen->pitch;
+
+	if (overlay || GUI.overlay)
+	{
+		for (int y = 170 - top; y < 170 + 30 - top && y < height; y++)
+			changed[y] = TRUE;
+	}
+	GUI.overlay = overlay;
+
+	renderVolume(GUI.sdl_screen);
+	UpdateRows(changed, height, 0, 1, width);
+#else
+	static int	prevWidth = 0, prevHeight = 0, prevMode = 0;
 	Blitter		blitFn = NULL;
-#if 0 // AWH
-	if (GUI.video_mode == VIDEOMODE_BLOCKY || GUI.video_mode == VIDEOMODE_TV || GUI.video_mode == VIDEOMODE_SMOOTH)
-		if ((width <= SNES_WIDTH) && ((prevWidth != width) || (prevHeight != height)))
-			S9xBlitClearDelta();
+
+	// The delta-based scalers only redraw what changed since their last frame
+	if ((width <= SNES_WIDTH) && ((prevWidth != width) || (prevHeight != height) || (prevMode != GUI.video_mode)))
+		S9xBlitClearDelta();
+
+	if (prevMode != GUI.video_mode)
+		Update.Valid = FALSE;
 
 	if (width <= SNES_WIDTH)
 	{
 		if (height > SNES_HEIGHT_EXTENDED)
-		{
-			copyWidth  = width * 2;
-			copyHeight = height;
 			blitFn = S9xBlitPixSimple2x1;
-		}
 		else
 		{
-			copyWidth  = width  * 2;
-			copyHeight = height * 2;
-
 			switch (GUI.video_mode)
 			{
 				case VIDEOMODE_BLOCKY:		blitFn = S9xBlitPixSimple2x2;		break;
 				case VIDEOMODE_TV:			blitFn = S9xBlitPixTV2x2;			break;
+				default:
 				case VIDEOMODE_SMOOTH:		blitFn = S9xBlitPixSmooth2x2;		break;
 				case VIDEOMODE_SUPEREAGLE:	blitFn = S9xBlitPixSuperEagle16;	break;
 				case VIDEOMODE_2XSAI:		blitFn = S9xBlitPix2xSaI16;			break;
@@ -334,9 +611,6 @@ void S9xPutImage (int width, int height)
 	else
 	if (height <= SNES_HEIGHT_EXTENDED)
 	{
-		copyWidth  = width;
-		copyHeight = height * 2;
-
 		switch (GUI.video_mode)
 		{
 			default:					blitFn = S9xBlitPixSimple1x2;	break;
@@ -344,43 +618,119 @@ void S9xPutImage (int width, int height)
 		}
 	}
 	else
-	{
-		copyWidth  = width;
-		copyHeight = height;
 		blitFn = S9xBlitPixSimple1x1;
-	}
-
 
-	// domaemon: this is place where the rendering buffer size should be changed?
-	blitFn((uint8 *) GFX.Screen, GFX.Pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
+	S9xBlitThreaded(blitFn, src, pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
 
 	// domaemon: does the height change on the fly?
 	if (height < prevHeight)
 	{
-		int	p = GUI.blit_screen_pitch >> 2;
-		for (int y = SNES_HEIGHT * 2; y < SNES_HEIGHT_EXTENDED * 2; y++)
-		{
-			uint32	*d = (uint32 *) (GUI.blit_screen + y * GUI.blit_screen_pitch);
-			for (int x = 0; x < p; x++)
-				*d++ = 0;
-		}
+		for (int y = height * 2; y < prevHeight * 2; y++)
+			memset(GUI.blit_screen + y * GUI.blit_screen_pitch, 0, SNES_WIDTH * 2 * 2);
 	}
-	Repaint(TRUE);
 
-	prevWidth  = width;
-	prevHeight = height;
-#else
-#if defined(CAPE_LCD3)
-S9xBlitPixSimple1x1((uint8 *) GFX.Screen, GFX.Pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
-renderVolume(GUI.sdl_screen);
-SDL_UpdateRect(GUI.sdl_screen, 0, 0, 0, 0);
-#else
-/*S9xBlitPixSimple2x2*/S9xBlitPixSmooth2x2((uint8 *) GFX.Screen, GFX.Pitch, GUI.blit_screen, GUI.blit_screen_pitch, width, height);
 // NTSC SDL_UpdateRect(GUI.sdl_screen, 104, 14, 512, 464 /* 478 - 14 */);
-SDL_UpdateRect(GUI.sdl_screen, 64, 12, 512, 464);
+	ChangedRows(src, pitch, width, height, changed);
+
+	// Only the 2x filters look at the lines around a pixel; SuperEagle and the
+	// 2xSaI filters reach two lines down.
+	bool8	alone = (blitFn == S9xBlitPixSimple2x2 || blitFn == S9xBlitPixTV2x2 || blitFn == S9xBlitPixSimple2x1 ||
+					 blitFn == S9xBlitPixSimple1x2 || blitFn == S9xBlitPixTV1x2 || blitFn == S9xBlitPixSimple1x1);
+
+	UpdateRows(changed, height, alone ? 0 : 2, (height > SNES_HEIGHT_EXTENDED) ? 1 : 2, SNES_WIDTH * 2);
 //Repaint(TRUE);
+
+	prevWidth  = width;
+	prevHeight = height;
+	prevMode   = GUI.video_mode;
 #endif
-#endif // AWH
+}
+
+// Compares each source line with the same line of the last frame copied out,
+// and keeps the new one in its place. A frame of another size changes them all.
+static void ChangedRows (uint8 *src, int pitch, int width, int height, bool8 *changed)
+{
+	int	bytes = width << 1, lastPitch = SNES_WIDTH * 2 * 2;
+
+	if (width != Update.Width || height != Update.Height)
+	{
+		Update.Valid  = FALSE;
+		Update.Width  = width;
+		Update.Height = height;
+	}
+
+	for (int y = 0; y < height; y++)
+	{
+		uint8	*last = Update.Last + y * lastPitch;
+
+		changed[y] = !Update.Valid || memcmp(last, src, bytes) != 0;
+		if (changed[y])
+			memcpy(last, src, bytes);
+
+		src += pitch;
+	}
+}
+
+// Pushes the screen rows of the changed source lines, each line taking scale
+// rows and also dirtying the reach lines either side, with runs of rows
+// merged into one rectangle. The first frame after a change of size or mode
+// pushes the whole screen, borders included.
+static void UpdateRows (const bool8 *changed, int height, int reach, int scale, int width)
+{
+	static SDL_Rect	rects[SNES_HEIGHT_EXTENDED];
+
+	int		offset = GUI.blit_screen - (uint8 *) GUI.sdl_screen->pixels;
+	int		left = (offset % GUI.sdl_screen->pitch) >> 1, top = offset / GUI.sdl_screen->pitch;
+	int		count = 0, rows = 0, start = -1;
+
+	if (!Update.Valid)
+	{
+		SDL_UpdateRect(GUI.sdl_screen, 0, 0, 0, 0);
+		Update.Valid = TRUE;
+		Update.Frames++;
+		Update.Rows += GUI.sdl_screen->h;
+		return;
+	}
+
+	if (width > GUI.sdl_screen->w - left)
+		width = GUI.sdl_screen->w - left;
+
+	for (int y = 0; y <= height; y++)
+	{
+		bool8	dirty = FALSE;
+
+		for (int i = y - reach; y < height && i <= y + reach && !dirty; i++)
+			dirty = (i >= 0 && i < height && changed[i]);
+
+		if (dirty && start < 0)
+			start = y;
+		else
+		if (!dirty && start >= 0)
+		{
+			int	y0 = top + start * scale, y1 = top + y * scale;
+
+			if (y1 > GUI.sdl_screen->h)
+				y1 = GUI.sdl_screen->h;
+
+			if (y1 > y0)
+			{
+				rects[count].x = left;
+				rects[count].y = y0;
+				rects[count].w = width;
+				rects[count].h = y1 - y0;
+				rows += y1 - y0;
+				count++;
+			}
+
+			start = -1;
+		}
+	}
+
+	if (count)
+		SDL_UpdateRects(GUI.sdl_screen, count, rects);
+
+	Update.Frames++;
+	Update.Rows += rows;
 }
 
 static void Repaint (bool8 isFrameBoundry)
@@ -394,6 +744,122 @@ SDL_UpdateRect(GUI.sdl_screen, 104, 6, 512, 472 /* 478 - 6 */);
 #endif // BeagleSNES
 }
 
+static uint64 PresentClock (void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64) ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+// Waits for the panel's vblank through the framebuffer device when the driver
+// has FBIO_WAITFORVSYNC, and otherwise sleeps to the next frame boundary.
+static void PresentWaitVBlank (void)
+{
+#ifdef FBIO_WAITFORVSYNC
+	if (Present.VSyncFD >= 0)
+	{
+		uint32	crtc = 0;
+
+		if (ioctl(Present.VSyncFD, FBIO_WAITFORVSYNC, &crtc) == 0)
+			return;
+
+		close(Present.VSyncFD);
+		Present.VSyncFD = -1;
+	}
+#endif
+
+	uint32	frame = Settings.FrameTime ? Settings.FrameTime : 16667;
+	uint64	now = PresentClock();
+
+	Present.NextVBlank += frame;
+	if (Present.NextVBlank < now || Present.NextVBlank > now + frame)
+		Present.NextVBlank = now + frame;
+
+	struct timespec	ts;
+	ts.tv_sec  = (Present.NextVBlank - now) / 1000000;
+	ts.tv_nsec = (Present.NextVBlank - now) % 1000000 * 1000;
+	while (nanosleep(&ts, &ts) < 0 && errno == EINTR) ;
+}
+
+static void * PresentThread (void *)
+{
+	while (!Present.Quit)
+	{
+		PresentWaitVBlank();
+
+		pthread_mutex_lock(&Present.Lock);
+		if (Present.Ready < 0)
+		{
+			pthread_mutex_unlock(&Present.Lock);
+			Present.Repeated++;
+			continue;
+		}
+		Present.Shown = Present.Ready;
+		Present.Ready = -1;
+		pthread_mutex_unlock(&Present.Lock);
+
+		int	n = Present.Shown;
+
+		if (SDL_MUSTLOCK(GUI.sdl_screen))
+			SDL_LockSurface(GUI.sdl_screen);
+		CopyImage(Present.Buffer[n] + (Present.Pitch * 2 * 2), Present.Pitch, Present.Width[n], Present.Height[n]);
+		if (SDL_MUSTLOCK(GUI.sdl_screen))
+			SDL_UnlockSurface(GUI.sdl_screen);
+
+		uint32	latency = (uint32) (PresentClock() - Present.Finished[n]);
+		Present.LatencyTotal += latency;
+		if (latency > Present.LatencyMax)
+			Present.LatencyMax = latency;
+		Present.Presented++;
+	}
+
+	return (NULL);
+}
+
+static void StartPresentThread (void)
+{
+	Present.VSyncFD = -1;
+#ifdef FBIO_WAITFORVSYNC
+	const char	*dev = getenv("SDL_FBDEV");
+	Present.VSyncFD = open(dev ? dev : "/dev/fb0", O_RDWR);
+#endif
+
+	Present.NextVBlank = PresentClock();
+	Present.Quit = FALSE;
+	pthread_mutex_init(&Present.Lock, NULL);
+	if (pthread_create(&Present.Thread, NULL, PresentThread, NULL) != 0)
+	{
+		// Fall back to copying from the emulation thread
+		pthread_mutex_destroy(&Present.Lock);
+		if (Present.VSyncFD >= 0)
+			close(Present.VSyncFD);
+		Present.Enabled = FALSE;
+		SetupImage();
+		return;
+	}
+
+	Present.Running = TRUE;
+}
+
+static void StopPresentThread (void)
+{
+	if (!Present.Running)
+		return;
+
+	Present.Quit = TRUE;
+	pthread_join(Present.Thread, NULL);
+	pthread_mutex_destroy(&Present.Lock);
+	if (Present.VSyncFD >= 0)
+		close(Present.VSyncFD);
+	Present.Running = FALSE;
+
+	fprintf(stderr, "present: %u frames, %u dropped, %u repeated, latency %u us avg, %u us max\n",
+		Present.Presented, Present.Dropped, Present.Repeated,
+		Present.Presented ? (uint32) (Present.LatencyTotal / Present.Presented) : 0, Present.LatencyMax);
+}
+
 void S9xMessage (int type, int number, const char *message)
 {
 	const int	max = 36 * 3;
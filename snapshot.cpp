@@ -1622,6 +1622,8 @@ int S9xUnfreezeFromStream (STREAM stream)
 		UnfreezeStructFromCopy(&dma_snap, SnapDMA, COUNT(SnapDMA), local_dma, version);
 
 		memcpy(Memory.VRAM, local_vram, 0x10000);
+		S9xMarkAllVRAMDirty();
+		S9xInvalidateLines(0, SNES_HEIGHT_EXTENDED - 1);
 
 		memcpy(Memory.RAM, local_ram, 0x20000);
 
@@ -1721,6 +1723,8 @@ int S9xUnfreezeFromStream (STREAM stream)
 		S9xSetPCBase(Registers.PBPC);
 		S9xUnpackStatus();
 		S9xFixCycles();
+		S9xResetIdleLoop();
+		S9xTimelineRestore();
 
 		for (int d = 0; d < 8; d++)
 			DMA[d] = dma_snap.dma[d];
@@ -1731,6 +1735,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 		S9xFixColourBrightness();
 		IPPU.ColorsChanged = TRUE;
 		IPPU.OBJChanged = TRUE;
+		memset(IPPU.OBJDirty, 0xff, sizeof(IPPU.OBJDirty));
 		IPPU.RenderThisFrame = TRUE;
 
 		uint8 hdma_byte = Memory.FillRAM[0x420c];
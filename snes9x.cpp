@@ -410,15 +410,25 @@ void S9xLoadConfigFiles (char **argv, int argc)
 	Settings.SoundPlaybackRate          =  conf.GetUInt("Sound::Rate",                         32000);
 	Settings.SoundInputRate             =  conf.GetUInt("Sound::InputRate",                    32000);
 	Settings.Mute                       =  conf.GetBool("Sound::Mute",                         false);
+	Settings.DynamicRateControl         =  conf.GetBool("Sound::DynamicRateControl",           false);
+	Settings.DynamicRateLimit           =  conf.GetUInt("Sound::DynamicRateLimit",             5);
+	Settings.SincResampler              =  conf.GetBool("Sound::SincResampler",                false);
+	Settings.BRRCache                   =  conf.GetBool("Sound::BRRCache",                     false);
 
 	// Display
 
 	Settings.SupportHiRes               =  conf.GetBool("Display::HiRes",                      true);
 	Settings.Transparency               =  conf.GetBool("Display::Transparency",               true);
 	Settings.DisableGraphicWindows      = !conf.GetBool("Display::GraphicWindows",             true);
+#ifdef RENDER_THREADS
+	Settings.RenderThreads              =  conf.GetUInt("Display::RenderThreads",              0);
+#endif
+	Settings.TileCacheSize              =  conf.GetUInt("Display::TileCacheSize",              256);
+	Settings.SkipUnchangedLines         =  conf.GetBool("Display::SkipUnchangedLines",         false);
 	Settings.DisplayFrameRate           =  conf.GetBool("Display::DisplayFrameRate",           false);
 	Settings.DisplayWatchedAddresses    =  conf.GetBool("Display::DisplayWatchedAddresses",    false);
 	Settings.DisplayPressedKeys         =  conf.GetBool("Display::DisplayInput",               false);
+	Settings.DisplayProfiler            =  conf.GetBool("Display::DisplayProfiler",            false);
 	Settings.DisplayMovieFrame          =  conf.GetBool("Display::DisplayFrameCount",          false);
 	Settings.AutoDisplayMessages        =  conf.GetBool("Display::MessagesInImage",            true);
 	Settings.InitialInfoStringTimeout   =  conf.GetInt ("Display::MessageDisplayTime",         120);
@@ -473,6 +483,8 @@ void S9xLoadConfigFiles (char **argv, int argc)
 	Settings.DisableGameSpecificHacks       = !conf.GetBool("Hack::EnableGameSpecificHacks",       true);
 	Settings.BlockInvalidVRAMAccessMaster   = !conf.GetBool("Hack::AllowInvalidVRAMAccess",        false);
 	Settings.HDMATimingHack                 =  conf.GetInt ("Hack::HDMATiming",                    100);
+	Settings.IdleLoopSkip                   =  conf.GetBool("Hack::IdleLoopSkip",                  false);
+	Settings.SA1Batch                       =  conf.GetBool("Hack::SA1Batch",                      false);
 
 	// Netplay
 
@@ -523,15 +535,26 @@ void S9xUsage (void)
 	S9xMessage(S9X_INFO, S9X_USAGE, "-nostereo                       Disable stereo sound output");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-eightbit                       Use 8bit sound instead of 16bit");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-mute                           Mute sound");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-dynamicrate                    Nudge the resampling ratio to keep the sound buffer");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                half full instead of syncing to sound");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-dynamicratelimit <n>           Maximum ratio change in 0.1% steps (default 5)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-sincresampler                  Use the 16-tap windowed sinc resampler (needs SSE2/NEON)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-brrcache                       Cache decoded BRR sample blocks");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	// DISPLAY OPTIONS
 	S9xMessage(S9X_INFO, S9X_USAGE, "-displayframerate               Display the frame rate counter");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-displaykeypress                Display input of all controllers and peripherals");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-displayprofiler                Display per-frame timing bars next to the frame rate");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-nohires                        (Not recommended) Disable support for hi-res and");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                interlace modes");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-notransparency                 (Not recommended) Disable transparency effects");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-nowindows                      (Not recommended) Disable graphic window effects");
+#ifdef RENDER_THREADS
+	S9xMessage(S9X_INFO, S9X_USAGE, "-renderthreads <n>              Draw the screen on <n> threads, one band of lines each");
+#endif
+	S9xMessage(S9X_INFO, S9X_USAGE, "-tilecache <kb>                 Memory for converted tiles, 0 for all of them (~1.2MB)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-skiplines                      Reuse lines that are unchanged since the last frame");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	// CONTROLLER OPTIONS
@@ -591,6 +614,8 @@ void S9xUsage (void)
 	S9xMessage(S9X_INFO, S9X_USAGE, "-hdmatiming <1-199>             (Not recommended) Changes HDMA transfer timings");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                event comes");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-invalidvramaccess              (Not recommended) Allow invalid VRAM access");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-idleloopskip                   Fast-forward through loops waiting for an event");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-sa1batch                       Run the SA1 in batches between main CPU syncs");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	// OTHER OPTIONS
@@ -661,6 +686,23 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-mute"))
 				Settings.Mute = TRUE;
 			else
+			if (!strcasecmp(argv[i], "-dynamicrate"))
+				Settings.DynamicRateControl = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-dynamicratelimit"))
+			{
+				if (i + 1 < argc)
+					Settings.DynamicRateLimit = atoi(argv[++i]);
+				else
+					S9xUsage();
+			}
+			else
+			if (!strcasecmp(argv[i], "-sincresampler"))
+				Settings.SincResampler = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-brrcache"))
+				Settings.BRRCache = TRUE;
+			else
 
 			// DISPLAY OPTIONS
 
@@ -670,6 +712,9 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-displaykeypress"))
 				Settings.DisplayPressedKeys = TRUE;
 			else
+			if (!strcasecmp(argv[i], "-displayprofiler"))
+				Settings.DisplayProfiler = TRUE;
+			else
 			if (!strcasecmp(argv[i], "-nohires"))
 				Settings.SupportHiRes = FALSE;
 			else
@@ -679,6 +724,27 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-nowindows"))
 				Settings.DisableGraphicWindows = TRUE;
 			else
+		#ifdef RENDER_THREADS
+			if (!strcasecmp(argv[i], "-renderthreads"))
+			{
+				if (i + 1 < argc)
+					Settings.RenderThreads = atoi(argv[++i]);
+				else
+					S9xUsage();
+			}
+			else
+		#endif
+			if (!strcasecmp(argv[i], "-tilecache"))
+			{
+				if (i + 1 < argc)
+					Settings.TileCacheSize = atoi(argv[++i]);
+				else
+					S9xUsage();
+			}
+			else
+			if (!strcasecmp(argv[i], "-skiplines"))
+				Settings.SkipUnchangedLines = TRUE;
+			else
 
 			// CONTROLLER OPTIONS
 
@@ -865,6 +931,12 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-invalidvramaccess"))
 				Settings.BlockInvalidVRAMAccessMaster = FALSE;
 			else
+			if (!strcasecmp(argv[i], "-idleloopskip"))
+				Settings.IdleLoopSkip = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-sa1batch"))
+				Settings.SA1Batch = TRUE;
+			else
 
 			// OTHER OPTIONS
 
@@ -305,7 +305,9 @@ enum
 	HC_HCOUNTER_MAX_EVENT = 3,
 	HC_HDMA_INIT_EVENT    = 4,
 	HC_RENDER_EVENT       = 5,
-	HC_WRAM_REFRESH_EVENT = 6
+	HC_WRAM_REFRESH_EVENT = 6,
+	HC_APU_SYNC_EVENT     = 7,
+	HC_SUPERFX_EVENT      = 8
 };
 
 struct STimings
@@ -379,15 +381,23 @@ struct SSettings
 	bool8	Stereo;
 	bool8	ReverseStereo;
 	bool8	Mute;
+	bool8	DynamicRateControl;
+	uint32	DynamicRateLimit;
+	bool8	SincResampler;
+	bool8	BRRCache;
 
 	bool8	SupportHiRes;
 	bool8	Transparency;
 	uint8	BG_Forced;
 	bool8	DisableGraphicWindows;
+	uint32	RenderThreads;
+	uint32	TileCacheSize;
+	bool8	SkipUnchangedLines;
 
 	bool8	DisplayFrameRate;
 	bool8	DisplayWatchedAddresses;
 	bool8	DisplayPressedKeys;
+	bool8	DisplayProfiler;
 	bool8	DisplayMovieFrame;
 	bool8	AutoDisplayMessages;
 	uint32	InitialInfoStringTimeout;
@@ -401,6 +411,8 @@ struct SSettings
 	bool8	BlockInvalidVRAMAccessMaster;
 	bool8	BlockInvalidVRAMAccess;
 	int32	HDMATimingHack;
+	bool8	IdleLoopSkip;
+	bool8	SA1Batch;
 
 	bool8	ForcedPause;
 	bool8	Paused;
@@ -199,6 +199,7 @@
 #include "memmap.h"
 #include "srtc.h"
 #include "display.h"
+#include "profiler.h"
 
 #define memory_cartrom_size()		Memory.CalculatedSize
 #define memory_cartrom_read(a)		Memory.ROM[(a)]
@@ -304,8 +305,12 @@ uint8 S9xGetSPC7110 (uint16 address)
 {
 	if (!Settings.SPC7110RTC && address > 0x483f)
 		return (OpenBus);
-	
-	return (s7emu.mmio_read(address));
+
+	PROFILE_BEGIN(PROF_SPC7110);
+	uint8	byte = s7emu.mmio_read(address);
+	PROFILE_END();
+
+	return (byte);
 }
 
 void S9xSetSPC7110 (uint8 byte, uint16 address)
@@ -313,10 +318,14 @@ void S9xSetSPC7110 (uint8 byte, uint16 address)
 	if (!Settings.SPC7110RTC && address > 0x483f)
 		return;
 
+	PROFILE_BEGIN(PROF_SPC7110);
+
 	if (address == 0x4830)
 		SetSPC7110SRAMMap(byte);
 
 	s7emu.mmio_write(address, byte);
+
+	PROFILE_END();
 }
 
 void S9xSPC7110PreSaveState (void)
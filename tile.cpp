@@ -180,6 +180,10 @@
 // The other option would be to have 4 files, where A includes B, and B includes C 3 times, and C includes D 5 times.
 // Look for the following marker to find where the divisions are.
 
+// The includes build one renderer per colour math op and layout, and defining PIXEL_FORMAT fixes the pixel format.
+// The BG loops in gfx.cpp pick a renderer once per clip window and call it once per tile (8 pixels).
+// Inlining the tile bodies, several KB each, into every BG loop copy would cost far more code than the call does.
+
 // Top-level compilation.
 
 #ifndef _NEWTILE_CPP
@@ -189,6 +193,30 @@
 #include "ppu.h"
 #include "tile.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TILE_SIMD_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TILE_SIMD_NEON
+#endif
+
+// The vector renderers work on RGB565 only: checked at run time, or fixed by the build.
+#if defined(TILE_SIMD_SSE2) || defined(TILE_SIMD_NEON)
+#if defined(GFX_MULTI_FORMAT)
+#define TILE_SIMD
+#define TILE_SIMD_FORMAT	(GFX.PixelFormat == RGB565)
+#elif RED_LOW_BIT_MASK == 0x0800 && GREEN_LOW_BIT_MASK == 0x0020 && BLUE_LOW_BIT_MASK == 0x0001
+#define TILE_SIMD
+#define TILE_SIMD_FORMAT	TRUE
+#endif
+#endif
+
+#ifdef TILE_SIMD
+static bool8	simd_renderers = TRUE;
+static bool8	simd_uncached = FALSE;	// GFX.Screen is slow to read back
+#endif
+
 static uint32	pixbit[8][16];
 static uint8	hrbit_odd[256];
 static uint8	hrbit_even[256];
@@ -253,6 +281,157 @@ void S9xInitTileRenderer (void)
 	}
 }
 
+// The tile cache. Every converted tile gets one 64-byte slot from a fixed pool.
+// When the pool is smaller than the number of tiles that could be cached, the least recently
+// drawn tile gives up its slot; its TileCached[] entry is left alone, so it is simply converted
+// again the next time it is drawn, into whatever slot it gets then.
+
+bool8 S9xInitTileCache (struct STileCache *c, uint32 kb)
+{
+	static const uint32	tiles[7] =
+	{
+		MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_8BIT_TILES, MAX_2BIT_TILES, MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_4BIT_TILES
+	};
+
+	uint32	slots = kb * (1024 / 64);
+
+	if (slots == 0 || slots > MAX_CACHED_TILES)
+		slots = MAX_CACHED_TILES;
+	if (slots < 64)
+		slots = 64;
+
+	memset(c, 0, sizeof(struct STileCache));
+
+	c->Slots   = slots;
+	c->Bounded = (slots < MAX_CACHED_TILES);
+	c->Data    = (uint8 *) calloc(slots, 64);
+	c->Owner   = (uint16 *) calloc(slots, sizeof(uint16));
+	c->Prev    = (uint16 *) calloc(slots, sizeof(uint16));
+	c->Next    = (uint16 *) calloc(slots, sizeof(uint16));
+
+	bool8	ok = c->Data && c->Owner && c->Prev && c->Next;
+
+	for (int f = 0; f < 7; f++)
+	{
+		c->Slot[f] = (uint16 *) calloc(tiles[f], sizeof(uint16));
+		ok = ok && c->Slot[f];
+	}
+
+	if (!ok)
+	{
+		S9xDeinitTileCache(c);
+		return (FALSE);
+	}
+
+	return (TRUE);
+}
+
+void S9xDeinitTileCache (struct STileCache *c)
+{
+	if (c->Data)  { free(c->Data);  c->Data  = NULL; }
+	if (c->Owner) { free(c->Owner); c->Owner = NULL; }
+	if (c->Prev)  { free(c->Prev);  c->Prev  = NULL; }
+	if (c->Next)  { free(c->Next);  c->Next  = NULL; }
+
+	for (int f = 0; f < 7; f++)
+	{
+		if (c->Slot[f])
+		{
+			free(c->Slot[f]);
+			c->Slot[f] = NULL;
+		}
+	}
+}
+
+static inline void TileCacheUnlink (struct STileCache *c, uint32 s)
+{
+	if (s == c->Head)
+		c->Head = c->Next[s];
+	else
+		c->Next[c->Prev[s]] = c->Next[s];
+
+	if (s == c->Tail)
+		c->Tail = c->Prev[s];
+	else
+		c->Prev[c->Next[s]] = c->Prev[s];
+}
+
+static inline void TileCachePushFront (struct STileCache *c, uint32 s)
+{
+	c->Next[s] = c->Head;
+	c->Prev[c->Head] = s;
+	c->Head = s;
+}
+
+// A resident, up to date tile was drawn.
+static inline uint8 * TileCacheHit (uint32 s)
+{
+	struct STileCache	*c = &IPPU.TileCache;
+
+	c->Hits++;
+
+	if (c->Bounded && s != c->Head)
+	{
+		TileCacheUnlink(c, s);
+		TileCachePushFront(c, s);
+	}
+
+	return (c->Data + (s << 6));
+}
+
+// The tile has no slot or has been written to since it was converted: (re)convert it.
+static uint8 * TileCacheMiss (uint32 Format, uint32 TileNumber, uint8 *Buffered, uint8 (*Convert) (uint8 *, uint32, uint32), uint32 TileAddr, uint32 Tile)
+{
+	struct STileCache	*c = &IPPU.TileCache;
+	uint32				s = c->Slot[Format][TileNumber];
+
+	c->Misses++;
+
+	if (s)
+	{
+		s--;
+
+		if (c->Bounded && s != c->Head)
+		{
+			TileCacheUnlink(c, s);
+			TileCachePushFront(c, s);
+		}
+	}
+	else
+	{
+		if (c->Used < c->Slots)
+		{
+			s = c->Used++;
+
+			if (s == 0)
+				c->Head = c->Tail = 0;
+			else
+				TileCachePushFront(c, s);
+		}
+		else
+		{
+			s = c->Tail;
+			c->Slot[c->Owner[s] >> 12][c->Owner[s] & 0xfff] = 0;
+			c->Evictions++;
+
+			if (s != c->Head)
+			{
+				TileCacheUnlink(c, s);
+				TileCachePushFront(c, s);
+			}
+		}
+
+		c->Owner[s] = (Format << 12) | TileNumber;
+		c->Slot[Format][TileNumber] = s + 1;
+	}
+
+	uint8	*pCache = c->Data + (s << 6);
+
+	Buffered[TileNumber] = Convert(pCache, TileAddr, Tile);
+
+	return (pCache);
+}
+
 // Here are the tile converters, selected by S9xSelectTileConverter().
 // Really, except for the definition of DOBIT and the number of times it is called, they're all the same.
 
@@ -265,7 +444,7 @@ void S9xInitTileRenderer (void)
 
 static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
 {
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
+	register uint8	*tp      = &GFX.VRAM[TileAddr];
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -288,7 +467,7 @@ static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
 
 static uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
 {
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
+	register uint8	*tp      = &GFX.VRAM[TileAddr];
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -313,7 +492,7 @@ static uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
 
 static uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
 {
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
+	register uint8	*tp      = &GFX.VRAM[TileAddr];
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -350,7 +529,7 @@ static uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
 
 static uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
+	register uint8	*tp1     = &GFX.VRAM[TileAddr], *tp2;
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -378,7 +557,7 @@ static uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 
 static uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
+	register uint8	*tp1     = &GFX.VRAM[TileAddr], *tp2;
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -416,7 +595,7 @@ static uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 
 static uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
+	register uint8	*tp1     = &GFX.VRAM[TileAddr], *tp2;
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -444,7 +623,7 @@ static uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 
 static uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
+	register uint8	*tp1     = &GFX.VRAM[TileAddr], *tp2;
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -474,6 +653,249 @@ static uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 
 #undef DOBIT
 
+#if defined(TILE_SIMD_SSE2) || defined(TILE_SIMD_NEON)
+
+// Vector versions of the tile converters.
+// Each pixel is built from its plane bits, highest plane first: acc = acc * 2 + bit.
+// A lane of the plane mask picks the bit of the plane byte that belongs to that pixel, so the
+// same kernel does normal tiles (all 8 bits of one tile) and hires tiles (every other bit of
+// two neighbouring tiles, tp1 for the left 4 pixels and tp2 for the right 4).
+// The 16 bytes at tp + 16 * k are planes 2k and 2k+1 of all 8 rows, interleaved by row.
+
+enum
+{
+	TILE_BITS_NORMAL,
+	TILE_BITS_ODD,
+	TILE_BITS_EVEN
+};
+
+static const uint8	TileBits[3][16] =
+{
+	{ 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 },
+	{ 0x40, 0x10, 0x04, 0x01, 0x40, 0x10, 0x04, 0x01, 0x40, 0x10, 0x04, 0x01, 0x40, 0x10, 0x04, 0x01 },
+	{ 0x80, 0x20, 0x08, 0x02, 0x80, 0x20, 0x08, 0x02, 0x80, 0x20, 0x08, 0x02, 0x80, 0x20, 0x08, 0x02 }
+};
+
+#ifdef TILE_SIMD_SSE2
+
+// 16 lanes are two rows. Every plane byte has to be spread over the 4 lanes it feeds:
+// unpacking a register with itself twice gives [plane 2k x4, plane 2k+1 x4] for each row.
+
+#define TILE_ADD_PLANE(acc, v) \
+	acc = _mm_sub_epi8(_mm_add_epi8(acc, acc), _mm_cmpeq_epi8(_mm_and_si128((v), bits), bits))
+
+#define TILE_ADD_ROWS(acc, r1, r2) \
+	r1 = _mm_shuffle_epi32(r1, _MM_SHUFFLE(3, 1, 2, 0)); \
+	r2 = _mm_shuffle_epi32(r2, _MM_SHUFFLE(3, 1, 2, 0)); \
+	TILE_ADD_PLANE(acc, _mm_unpackhi_epi32(r1, r2)); \
+	TILE_ADD_PLANE(acc, _mm_unpacklo_epi32(r1, r2))
+
+// Adds planes 2k+1 and 2k to all 8 rows. After the shuffle a row pair is [even row a, even row b, odd row a, odd row b].
+
+static inline void ConvertTileBlock (__m128i &acc0, __m128i &acc1, __m128i &acc2, __m128i &acc3, const uint8 *tp1, const uint8 *tp2, __m128i bits)
+{
+	__m128i	v1 = _mm_loadu_si128((const __m128i *) tp1);
+	__m128i	v2 = _mm_loadu_si128((const __m128i *) tp2);
+	__m128i	lo1 = _mm_unpacklo_epi8(v1, v1), hi1 = _mm_unpackhi_epi8(v1, v1);
+	__m128i	lo2 = _mm_unpacklo_epi8(v2, v2), hi2 = _mm_unpackhi_epi8(v2, v2);
+	__m128i	r1, r2;
+
+	r1 = _mm_unpacklo_epi16(lo1, lo1);
+	r2 = _mm_unpacklo_epi16(lo2, lo2);
+	TILE_ADD_ROWS(acc0, r1, r2);
+
+	r1 = _mm_unpackhi_epi16(lo1, lo1);
+	r2 = _mm_unpackhi_epi16(lo2, lo2);
+	TILE_ADD_ROWS(acc1, r1, r2);
+
+	r1 = _mm_unpacklo_epi16(hi1, hi1);
+	r2 = _mm_unpacklo_epi16(hi2, hi2);
+	TILE_ADD_ROWS(acc2, r1, r2);
+
+	r1 = _mm_unpackhi_epi16(hi1, hi1);
+	r2 = _mm_unpackhi_epi16(hi2, hi2);
+	TILE_ADD_ROWS(acc3, r1, r2);
+}
+
+#undef TILE_ADD_ROWS
+#undef TILE_ADD_PLANE
+
+static inline uint8 ConvertTilePlanes (uint8 *pCache, const uint8 *tp1, const uint8 *tp2, int blocks, int sel)
+{
+	__m128i	bits = _mm_loadu_si128((const __m128i *) TileBits[sel]);
+	__m128i	acc0 = _mm_setzero_si128(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+
+	if (blocks > 2)
+	{
+		ConvertTileBlock(acc0, acc1, acc2, acc3, tp1 + 48, tp2 + 48, bits);
+		ConvertTileBlock(acc0, acc1, acc2, acc3, tp1 + 32, tp2 + 32, bits);
+	}
+
+	if (blocks > 1)
+		ConvertTileBlock(acc0, acc1, acc2, acc3, tp1 + 16, tp2 + 16, bits);
+
+	ConvertTileBlock(acc0, acc1, acc2, acc3, tp1, tp2, bits);
+
+	_mm_storeu_si128((__m128i *) (pCache +  0), acc0);
+	_mm_storeu_si128((__m128i *) (pCache + 16), acc1);
+	_mm_storeu_si128((__m128i *) (pCache + 32), acc2);
+	_mm_storeu_si128((__m128i *) (pCache + 48), acc3);
+
+	__m128i	non_zero = _mm_or_si128(_mm_or_si128(acc0, acc1), _mm_or_si128(acc2, acc3));
+
+	return ((_mm_movemask_epi8(_mm_cmpeq_epi8(non_zero, _mm_setzero_si128())) != 0xffff) ? TRUE : BLANK_TILE);
+}
+
+#else
+
+// 8 lanes are one row. The plane byte of the left tile fills lanes 0-3 and the right tile lanes 4-7.
+
+static inline uint8 ConvertTilePlanes (uint8 *pCache, const uint8 *tp1, const uint8 *tp2, int blocks, int sel)
+{
+	uint8x8_t	bits = vld1_u8(TileBits[sel]);
+	uint8x8_t	left = vcreate_u8(0x00000000ffffffffULL);
+	uint8x8_t	non_zero = vdup_n_u8(0);
+
+	for (int r = 0; r < 8; r++)
+	{
+		uint8x8_t	acc = vdup_n_u8(0);
+
+		for (int n = blocks * 2 - 1; n >= 0; n--)
+		{
+			int			o = 16 * (n >> 1) + 2 * r + (n & 1);
+			uint8x8_t	v = vbsl_u8(left, vdup_n_u8(tp1[o]), vdup_n_u8(tp2[o]));
+
+			acc = vsub_u8(vadd_u8(acc, acc), vtst_u8(v, bits));
+		}
+
+		vst1_u8(pCache + 8 * r, acc);
+		non_zero = vorr_u8(non_zero, acc);
+	}
+
+	return (vget_lane_u64(vreinterpret_u64_u8(non_zero), 0) ? TRUE : BLANK_TILE);
+}
+
+#endif
+
+static uint8 ConvertTile2SIMD (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	uint8	*tp = &GFX.VRAM[TileAddr];
+
+	return (ConvertTilePlanes(pCache, tp, tp, 1, TILE_BITS_NORMAL));
+}
+
+static uint8 ConvertTile4SIMD (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	uint8	*tp = &GFX.VRAM[TileAddr];
+
+	return (ConvertTilePlanes(pCache, tp, tp, 2, TILE_BITS_NORMAL));
+}
+
+static uint8 ConvertTile8SIMD (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	uint8	*tp = &GFX.VRAM[TileAddr];
+
+	return (ConvertTilePlanes(pCache, tp, tp, 4, TILE_BITS_NORMAL));
+}
+
+static uint8 ConvertTile2h_oddSIMD (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	uint8	*tp1 = &GFX.VRAM[TileAddr];
+	uint8	*tp2 = (Tile == 0x3ff) ? tp1 - (0x3ff << 4) : tp1 + (1 << 4);
+
+	return (ConvertTilePlanes(pCache, tp1, tp2, 1, TILE_BITS_ODD));
+}
+
+static uint8 ConvertTile4h_oddSIMD (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	uint8	*tp1 = &GFX.VRAM[TileAddr];
+	uint8	*tp2 = (Tile == 0x3ff) ? tp1 - (0x3ff << 5) : tp1 + (1 << 5);
+
+	return (ConvertTilePlanes(pCache, tp1, tp2, 2, TILE_BITS_ODD));
+}
+
+static uint8 ConvertTile2h_evenSIMD (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	uint8	*tp1 = &GFX.VRAM[TileAddr];
+	uint8	*tp2 = (Tile == 0x3ff) ? tp1 - (0x3ff << 4) : tp1 + (1 << 4);
+
+	return (ConvertTilePlanes(pCache, tp1, tp2, 1, TILE_BITS_EVEN));
+}
+
+static uint8 ConvertTile4h_evenSIMD (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	uint8	*tp1 = &GFX.VRAM[TileAddr];
+	uint8	*tp2 = (Tile == 0x3ff) ? tp1 - (0x3ff << 5) : tp1 + (1 << 5);
+
+	return (ConvertTilePlanes(pCache, tp1, tp2, 2, TILE_BITS_EVEN));
+}
+
+static uint8 (*ConvertersSIMD[TILE_CONVERT_COUNT]) (uint8 *, uint32, uint32) =
+{
+	ConvertTile2SIMD,
+	ConvertTile4SIMD,
+	ConvertTile8SIMD,
+	ConvertTile2h_oddSIMD,
+	ConvertTile4h_oddSIMD,
+	ConvertTile2h_evenSIMD,
+	ConvertTile4h_evenSIMD
+};
+
+#endif
+
+static uint8 (*ConvertersScalar[TILE_CONVERT_COUNT]) (uint8 *, uint32, uint32) =
+{
+	ConvertTile2,
+	ConvertTile4,
+	ConvertTile8,
+	ConvertTile2h_odd,
+	ConvertTile4h_odd,
+	ConvertTile2h_even,
+	ConvertTile4h_even
+};
+
+#if defined(TILE_SIMD_SSE2) || defined(TILE_SIMD_NEON)
+static uint8 (**Converters) (uint8 *, uint32, uint32) = ConvertersSIMD;
+#else
+static uint8 (**Converters) (uint8 *, uint32, uint32) = ConvertersScalar;
+#endif
+
+const char * S9xTileConverterSIMDName (void)
+{
+#if defined(TILE_SIMD_SSE2)
+	return ("SSE2");
+#elif defined(TILE_SIMD_NEON)
+	return ("NEON");
+#else
+	return (NULL);
+#endif
+}
+
+uint8 S9xConvertTile (int kind, bool8 simd, uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	return ((simd ? Converters : ConvertersScalar)[kind](pCache, TileAddr, Tile));
+}
+
+// Takes effect from the next S9xSelectTileRenderers/S9xSelectTileConverter call.
+void S9xSetTileSIMD (bool8 enable)
+{
+#if defined(TILE_SIMD_SSE2) || defined(TILE_SIMD_NEON)
+	Converters = enable ? ConvertersSIMD : ConvertersScalar;
+#endif
+#ifdef TILE_SIMD
+	simd_renderers = enable;
+#endif
+}
+
+// For a GFX.Screen in video memory, where reads are far slower than writes, so the vector renderers
+// never load from it. Partial rows then store pixel by pixel, which costs more in system memory.
+void S9xSetTileScreenUncached (bool8 uncached)
+{
+#ifdef TILE_SIMD
+	simd_uncached = uncached;
+#endif
+}
+
 // First-level include: Get all the renderers.
 
 #include "tile.cpp"
@@ -505,6 +927,13 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 		DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal1x1 : Renderers_DrawMode7BG1Normal1x1;
 		DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal1x1 : Renderers_DrawMode7BG2Normal1x1;
 		GFX.LinesPerTile = 8;
+	#ifdef TILE_SIMD
+		if (TILE_SIMD_FORMAT && simd_renderers)
+		{
+			DT = Renderers_DrawTile16SIMD;
+			DB = Renderers_DrawBackdrop16SIMD;
+		}
+	#endif
 	}
 	else if(hires)					// hires double width
 	{
@@ -566,11 +995,11 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 		i = 0;
 	else
 	{
-		i = (Memory.FillRAM[0x2131] & 0x80) ? 4 : 1;
-		if (Memory.FillRAM[0x2131] & 0x40)
+		i = (GFX.FillRAM[0x2131] & 0x80) ? 4 : 1;
+		if (GFX.FillRAM[0x2131] & 0x40)
 		{
 			i++;
-			if (Memory.FillRAM[0x2130] & 2)
+			if (GFX.FillRAM[0x2130] & 2)
 				i++;
 		}
 	}
@@ -588,13 +1017,14 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 	switch (depth)
 	{
 		case 8:
-			BG.ConvertTile      = BG.ConvertTileFlip = ConvertTile8;
-			BG.Buffer           = BG.BufferFlip      = IPPU.TileCache[TILE_8BIT];
+			BG.ConvertTile      = BG.ConvertTileFlip = Converters[TILE_CONVERT_8];
+			BG.Format           = BG.FormatFlip      = TILE_8BIT;
+			BG.Slot             = BG.SlotFlip        = IPPU.TileCache.Slot[TILE_8BIT];
 			BG.Buffered         = BG.BufferedFlip    = IPPU.TileCached[TILE_8BIT];
 			BG.TileShift        = 6;
 			BG.PaletteShift     = 0;
 			BG.PaletteMask      = 0;
-			BG.DirectColourMode = Memory.FillRAM[0x2130] & 1;
+			BG.DirectColourMode = GFX.FillRAM[0x2130] & 1;
 
 			break;
 
@@ -603,27 +1033,32 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 			{
 				if (sub || mosaic)
 				{
-					BG.ConvertTile     = ConvertTile4h_even;
-					BG.Buffer          = IPPU.TileCache[TILE_4BIT_EVEN];
+					BG.ConvertTile     = Converters[TILE_CONVERT_4H_EVEN];
+					BG.Format          = TILE_4BIT_EVEN;
+					BG.Slot            = IPPU.TileCache.Slot[TILE_4BIT_EVEN];
 					BG.Buffered        = IPPU.TileCached[TILE_4BIT_EVEN];
-					BG.ConvertTileFlip = ConvertTile4h_odd;
-					BG.BufferFlip      = IPPU.TileCache[TILE_4BIT_ODD];
+					BG.ConvertTileFlip = Converters[TILE_CONVERT_4H_ODD];
+					BG.FormatFlip      = TILE_4BIT_ODD;
+					BG.SlotFlip        = IPPU.TileCache.Slot[TILE_4BIT_ODD];
 					BG.BufferedFlip    = IPPU.TileCached[TILE_4BIT_ODD];
 				}
 				else
 				{
-					BG.ConvertTile     = ConvertTile4h_odd;
-					BG.Buffer          = IPPU.TileCache[TILE_4BIT_ODD];
+					BG.ConvertTile     = Converters[TILE_CONVERT_4H_ODD];
+					BG.Format          = TILE_4BIT_ODD;
+					BG.Slot            = IPPU.TileCache.Slot[TILE_4BIT_ODD];
 					BG.Buffered        = IPPU.TileCached[TILE_4BIT_ODD];
-					BG.ConvertTileFlip = ConvertTile4h_even;
-					BG.BufferFlip      = IPPU.TileCache[TILE_4BIT_EVEN];
+					BG.ConvertTileFlip = Converters[TILE_CONVERT_4H_EVEN];
+					BG.FormatFlip      = TILE_4BIT_EVEN;
+					BG.SlotFlip        = IPPU.TileCache.Slot[TILE_4BIT_EVEN];
 					BG.BufferedFlip    = IPPU.TileCached[TILE_4BIT_EVEN];
 				}
 			}
 			else
 			{
-				BG.ConvertTile = BG.ConvertTileFlip = ConvertTile4;
-				BG.Buffer      = BG.BufferFlip      = IPPU.TileCache[TILE_4BIT];
+				BG.ConvertTile = BG.ConvertTileFlip = Converters[TILE_CONVERT_4];
+				BG.Format      = BG.FormatFlip      = TILE_4BIT;
+				BG.Slot        = BG.SlotFlip        = IPPU.TileCache.Slot[TILE_4BIT];
 				BG.Buffered    = BG.BufferedFlip    = IPPU.TileCached[TILE_4BIT];
 			}
 
@@ -639,27 +1074,32 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 			{
 				if (sub || mosaic)
 				{
-					BG.ConvertTile     = ConvertTile2h_even;
-					BG.Buffer          = IPPU.TileCache[TILE_2BIT_EVEN];
+					BG.ConvertTile     = Converters[TILE_CONVERT_2H_EVEN];
+					BG.Format          = TILE_2BIT_EVEN;
+					BG.Slot            = IPPU.TileCache.Slot[TILE_2BIT_EVEN];
 					BG.Buffered        = IPPU.TileCached[TILE_2BIT_EVEN];
-					BG.ConvertTileFlip = ConvertTile2h_odd;
-					BG.BufferFlip      = IPPU.TileCache[TILE_2BIT_ODD];
+					BG.ConvertTileFlip = Converters[TILE_CONVERT_2H_ODD];
+					BG.FormatFlip      = TILE_2BIT_ODD;
+					BG.SlotFlip        = IPPU.TileCache.Slot[TILE_2BIT_ODD];
 					BG.BufferedFlip    = IPPU.TileCached[TILE_2BIT_ODD];
 				}
 				else
 				{
-					BG.ConvertTile     = ConvertTile2h_odd;
-					BG.Buffer          = IPPU.TileCache[TILE_2BIT_ODD];
+					BG.ConvertTile     = Converters[TILE_CONVERT_2H_ODD];
+					BG.Format          = TILE_2BIT_ODD;
+					BG.Slot            = IPPU.TileCache.Slot[TILE_2BIT_ODD];
 					BG.Buffered        = IPPU.TileCached[TILE_2BIT_ODD];
-					BG.ConvertTileFlip = ConvertTile2h_even;
-					BG.BufferFlip      = IPPU.TileCache[TILE_2BIT_EVEN];
+					BG.ConvertTileFlip = Converters[TILE_CONVERT_2H_EVEN];
+					BG.FormatFlip      = TILE_2BIT_EVEN;
+					BG.SlotFlip        = IPPU.TileCache.Slot[TILE_2BIT_EVEN];
 					BG.BufferedFlip    = IPPU.TileCached[TILE_2BIT_EVEN];
 				}
 			}
 			else
 			{
-				BG.ConvertTile = BG.ConvertTileFlip = ConvertTile2;
-				BG.Buffer      = BG.BufferFlip      = IPPU.TileCache[TILE_2BIT];
+				BG.ConvertTile = BG.ConvertTileFlip = Converters[TILE_CONVERT_2];
+				BG.Format      = BG.FormatFlip      = TILE_2BIT;
+				BG.Slot        = BG.SlotFlip        = IPPU.TileCache.Slot[TILE_2BIT];
 				BG.Buffered    = BG.BufferedFlip    = IPPU.TileCached[TILE_2BIT];
 			}
 
@@ -686,15 +1126,17 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 	TileNumber = TileAddr >> BG.TileShift; \
 	if (Tile & H_FLIP) \
 	{ \
-		pCache = &BG.BufferFlip[TileNumber << 6]; \
-		if (!BG.BufferedFlip[TileNumber]) \
-			BG.BufferedFlip[TileNumber] = BG.ConvertTileFlip(pCache, TileAddr, Tile & 0x3ff); \
+		if (BG.SlotFlip[TileNumber] && BG.BufferedFlip[TileNumber]) \
+			pCache = TileCacheHit(BG.SlotFlip[TileNumber] - 1); \
+		else \
+			pCache = TileCacheMiss(BG.FormatFlip, TileNumber, BG.BufferedFlip, BG.ConvertTileFlip, TileAddr, Tile & 0x3ff); \
 	} \
 	else \
 	{ \
-		pCache = &BG.Buffer[TileNumber << 6]; \
-		if (!BG.Buffered[TileNumber]) \
-			BG.Buffered[TileNumber] = BG.ConvertTile(pCache, TileAddr, Tile & 0x3ff); \
+		if (BG.Slot[TileNumber] && BG.Buffered[TileNumber]) \
+			pCache = TileCacheHit(BG.Slot[TileNumber] - 1); \
+		else \
+			pCache = TileCacheMiss(BG.Format, TileNumber, BG.Buffered, BG.ConvertTile, TileAddr, Tile & 0x3ff); \
 	}
 
 #define IS_BLANK_TILE() \
@@ -1025,16 +1467,102 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 
 extern struct SLineMatrixData	LineMatrixData[240];
 
+// Mode 7 lines are sampled into a texel buffer before drawing, so the per-pixel work in the renderers is only the
+// depth test and the colour lookup.  X0/Y0 is the first texel in 8.8 fixed point and dx/dy the per-pixel step, with
+// both flips already folded in.  Texels outside the playfield come back as 0 unless the repeat mode fills with tile 0;
+// every renderer treats 0 as transparent.
+
+#define M7_STEP(expr) \
+	{ \
+		expr; \
+		X0 += dx; \
+		n++; \
+	}
+
+#define M7_UNROLL(expr) \
+	while (n + 8 <= count) \
+	{ \
+		M7_STEP(expr); M7_STEP(expr); M7_STEP(expr); M7_STEP(expr); \
+		M7_STEP(expr); M7_STEP(expr); M7_STEP(expr); M7_STEP(expr); \
+	} \
+	\
+	while (n < count) \
+		M7_STEP(expr)
+
+static void Mode7SampleLine (uint8 *dst, int count, int X0, int Y0, int dx, int dy)
+{
+	// Texel stores may alias anything, so keep the VRAM pointer and repeat mode in locals.
+	uint8	*VRAM  = GFX.VRAM;
+	uint8	*VRAM1 = VRAM + 1;
+	int		repeat = PPU.Mode7Repeat;
+	int		n = 0;
+
+	if (dy == 0)
+	{
+		// No rotation: the whole line reads one row of the tilemap and one row of each tile.
+		int	Y = Y0 >> 8;
+
+		if (!repeat)
+			Y &= 0x3ff;
+
+		uint8	*map = VRAM  + ((Y & ~7) << 5);
+		uint8	*row = VRAM1 + ((Y & 7) << 4);
+
+		if (!repeat)
+		{
+			M7_UNROLL(int X = (X0 >> 8) & 0x3ff; dst[n] = row[(map[(X >> 2) & ~1] << 7) + ((X & 7) << 1)]);
+		}
+		else
+		if (Y & ~0x3ff)
+		{
+			if (repeat != 3)
+				memset(dst, 0, count);
+			else
+			{
+				M7_UNROLL(dst[n] = row[((X0 >> 8) & 7) << 1]);
+			}
+		}
+		else
+		if (repeat == 3)
+		{
+			M7_UNROLL(int X = X0 >> 8; dst[n] = row[((X & ~0x3ff) ? 0 : (map[(X >> 2) & ~1] << 7)) + ((X & 7) << 1)]);
+		}
+		else
+		{
+			M7_UNROLL(int X = X0 >> 8; dst[n] = (X & ~0x3ff) ? 0 : row[(map[(X >> 2) & ~1] << 7) + ((X & 7) << 1)]);
+		}
+
+		return;
+	}
+
+	if (!repeat)
+	{
+		M7_UNROLL(int X = (X0 >> 8) & 0x3ff; int Y = (Y0 >> 8) & 0x3ff; Y0 += dy;
+			dst[n] = VRAM1[(VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7) + ((Y & 7) << 4) + ((X & 7) << 1)]);
+	}
+	else
+	{
+		bool8	fill = (repeat == 3);
+
+		M7_UNROLL(int X = X0 >> 8; int Y = Y0 >> 8; Y0 += dy;
+			if (((X | Y) & ~0x3ff) == 0)
+				dst[n] = VRAM1[(VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7) + ((Y & 7) << 4) + ((X & 7) << 1)];
+			else
+				dst[n] = fill ? VRAM1[((Y & 7) << 4) + ((X & 7) << 1)] : 0);
+	}
+}
+
+#undef M7_STEP
+#undef M7_UNROLL
+
 #define NO_INTERLACE	1
 #define Z1				(D + 7)
 #define Z2				(D + 7)
 #define MASK			0xff
-#define DCMODE			(Memory.FillRAM[0x2130] & 1)
+#define DCMODE			(GFX.FillRAM[0x2130] & 1)
 #define BG				0
 
 #define DRAW_TILE_NORMAL() \
-	uint8	*VRAM1 = Memory.VRAM + 1; \
-	\
 	if (DCMODE) \
 	{ \
 		if (IPPU.DirectColourMapsNeedRebuild) \
@@ -1046,8 +1574,9 @@ extern struct SLineMatrixData	LineMatrixData[240];
 	\
 	GFX.ScreenColors = GFX.ClipColors ? BlackColourMap : GFX.RealScreenColors; \
 	\
-	int	aa, cc; \
-	int	startx; \
+	int		aa, cc; \
+	int		startx; \
+	uint8	Texels[SNES_WIDTH]; \
 	\
 	uint32	Offset = GFX.StartY * GFX.PPL; \
 	struct SLineMatrixData	*l = &LineMatrixData[GFX.StartY]; \
@@ -1091,46 +1620,19 @@ extern struct SLineMatrixData	LineMatrixData[240];
 		\
 		uint8	Pix; \
 		\
-		if (!PPU.Mode7Repeat) \
-		{ \
-			for (uint32 x = Left; x < Right; x++, AA += aa, CC += cc) \
-			{ \
-				int	X = ((AA + BB) >> 8) & 0x3ff; \
-				int	Y = ((CC + DD) >> 8) & 0x3ff; \
-				\
-				uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
-				uint8	b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
-				\
-				DRAW_PIXEL(x, Pix = (b & MASK)); \
-			} \
-		} \
-		else \
+		Mode7SampleLine(Texels, Right - Left, AA + BB, CC + DD, aa, cc); \
+		\
+		for (uint32 x = Left; x < Right; x++) \
 		{ \
-			for (uint32 x = Left; x < Right; x++, AA += aa, CC += cc) \
-			{ \
-				int	X = ((AA + BB) >> 8); \
-				int	Y = ((CC + DD) >> 8); \
-				\
-				uint8	b; \
-				\
-				if (((X | Y) & ~0x3ff) == 0) \
-				{ \
-					uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
-					b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
-				} \
-				else \
-				if (PPU.Mode7Repeat == 3) \
-					b = *(VRAM1    + ((Y & 7) << 4) + ((X & 7) << 1)); \
-				else \
-					continue; \
-				\
+			uint8	b = Texels[x - Left]; \
+			\
+			if (b) \
 				DRAW_PIXEL(x, Pix = (b & MASK)); \
-			} \
 		} \
 	}
 
 #define DRAW_TILE_MOSAIC() \
-	uint8	*VRAM1 = Memory.VRAM + 1; \
+	uint8	*VRAM1 = GFX.VRAM + 1; \
 	\
 	if (DCMODE) \
 	{ \
@@ -1221,7 +1723,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 				int	X = ((AA + BB) >> 8) & 0x3ff; \
 				int	Y = ((CC + DD) >> 8) & 0x3ff; \
 				\
-				uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+				uint8	*TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
 				uint8	b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
 				\
 				if ((Pix = (b & MASK))) \
@@ -1249,7 +1751,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 				\
 				if (((X | Y) & ~0x3ff) == 0) \
 				{ \
-					uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+					uint8	*TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
 					b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
 				} \
 				else \
@@ -1332,6 +1834,283 @@ extern struct SLineMatrixData	LineMatrixData[240];
 #undef Z2
 #undef NO_INTERLACE
 
+#ifdef TILE_SIMD
+
+// Vector versions of the Normal1x1 DrawTile16 and DrawBackdrop16 renderers, for RGB565 only.
+// A tile row is 8 pixels, so one row is one vector of 8 16-bit lanes. The palette lookup stays scalar,
+// then the depth test, colour math and stores to GFX.S and GFX.DB are done for the whole row at once.
+// The results are the same as the scalar COLOR_ADD/COLOR_SUB macros for RGB565.
+// Clipped tiles and mosaic pixels can start before the row they draw on, so they stay scalar.
+
+#ifdef TILE_SIMD_SSE2
+
+typedef __m128i	TileVec;
+
+#define TileLoad(p)			_mm_loadu_si128((const __m128i *) (p))
+#define TileStore(p, v)		_mm_storeu_si128((__m128i *) (p), (v))
+#define TileLoadZ(p)		_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (p)), _mm_setzero_si128())
+#define TileStoreZ(p, v)	_mm_storel_epi64((__m128i *) (p), _mm_packus_epi16((v), (v)))
+#define TileDup(n)			_mm_set1_epi16((short) (n))
+#define TileAnd(a, b)		_mm_and_si128((a), (b))
+#define TileOr(a, b)		_mm_or_si128((a), (b))
+#define TileXor(a, b)		_mm_xor_si128((a), (b))
+#define TileSelect(m, a, b)	_mm_or_si128(_mm_and_si128((m), (a)), _mm_andnot_si128((m), (b)))
+#define TileCmpEq(a, b)		_mm_cmpeq_epi16((a), (b))
+#define TileCmpGt(a, b)		_mm_cmpgt_epi16((a), (b))	// signed, only used on depths
+#define TileAny(m)			(_mm_movemask_epi8(m) != 0)
+#define TileAll(m)			(_mm_movemask_epi8(m) == 0xffff)
+#define TileAdd(a, b)		_mm_add_epi16((a), (b))
+#define TileAddSat(a, b)	_mm_adds_epu16((a), (b))
+#define TileSubSat(a, b)	_mm_subs_epu16((a), (b))
+#define TileShl(v, n)		_mm_slli_epi16((v), (n))
+#define TileShr(v, n)		_mm_srli_epi16((v), (n))
+
+#else
+
+typedef uint16x8_t	TileVec;
+
+static inline bool8 TileAnyNEON (uint16x8_t m)
+{
+	uint32x2_t	n = vreinterpret_u32_u8(vmovn_u16(m));
+
+	return ((vget_lane_u32(n, 0) | vget_lane_u32(n, 1)) != 0);
+}
+
+static inline bool8 TileAllNEON (uint16x8_t m)
+{
+	uint32x2_t	n = vreinterpret_u32_u8(vmovn_u16(m));
+
+	return ((vget_lane_u32(n, 0) & vget_lane_u32(n, 1)) == 0xffffffff);
+}
+
+#define TileLoad(p)			vld1q_u16((const uint16 *) (p))
+#define TileStore(p, v)		vst1q_u16((uint16 *) (p), (v))
+#define TileLoadZ(p)		vmovl_u8(vld1_u8((const uint8 *) (p)))
+#define TileStoreZ(p, v)	vst1_u8((uint8 *) (p), vmovn_u16(v))
+#define TileDup(n)			vdupq_n_u16((uint16) (n))
+#define TileAnd(a, b)		vandq_u16((a), (b))
+#define TileOr(a, b)		vorrq_u16((a), (b))
+#define TileXor(a, b)		veorq_u16((a), (b))
+#define TileSelect(m, a, b)	vbslq_u16((m), (a), (b))
+#define TileCmpEq(a, b)		vceqq_u16((a), (b))
+#define TileCmpGt(a, b)		vcgtq_u16((a), (b))
+#define TileAny(m)			TileAnyNEON(m)
+#define TileAll(m)			TileAllNEON(m)
+#define TileAdd(a, b)		vaddq_u16((a), (b))
+#define TileAddSat(a, b)	vqaddq_u16((a), (b))
+#define TileSubSat(a, b)	vqsubq_u16((a), (b))
+#define TileShl(v, n)		vshlq_n_u16((v), (n))
+#define TileShr(v, n)		vshrq_n_u16((v), (n))
+
+#endif
+
+// Each channel is shifted to the top of the lane, so the unsigned saturating add/sub clamps it to 0 or max.
+
+static inline TileVec TileColourAdd (TileVec a, TileVec b)
+{
+	TileVec	r = TileAddSat(TileAnd(a, TileDup(0xf800)), TileAnd(b, TileDup(0xf800)));
+	TileVec	g = TileAddSat(TileAnd(TileShl(a, 5), TileDup(0xfc00)), TileAnd(TileShl(b, 5), TileDup(0xfc00)));
+	TileVec	l = TileAddSat(TileShl(a, 11), TileShl(b, 11));
+
+	return (TileOr(TileAnd(r, TileDup(0xf800)), TileOr(TileAnd(TileShr(g, 5), TileDup(0x07e0)), TileShr(l, 11))));
+}
+
+static inline TileVec TileColourAdd1_2 (TileVec a, TileVec b)
+{
+	return (TileAdd(TileShr(TileAnd(TileXor(a, b), TileDup(0xf7de)), 1), TileAnd(a, b)));
+}
+
+static inline TileVec TileColourSub (TileVec a, TileVec b)
+{
+	TileVec	r = TileSubSat(TileAnd(a, TileDup(0xf800)), TileAnd(b, TileDup(0xf800)));
+	TileVec	g = TileSubSat(TileAnd(TileShl(a, 5), TileDup(0xfc00)), TileAnd(TileShl(b, 5), TileDup(0xfc00)));
+	TileVec	l = TileSubSat(TileShl(a, 11), TileShl(b, 11));
+
+	return (TileOr(r, TileOr(TileShr(g, 5), TileShr(l, 11))));
+}
+
+static inline TileVec TileColourSub1_2 (TileVec a, TileVec b)
+{
+	return (TileColourSub(TileAnd(TileShr(a, 1), TileDup(0x7bef)), TileAnd(TileShr(b, 1), TileDup(0x7bef))));
+}
+
+// Depth test, colour math and store for 8 pixels at Offset.
+// Draw masks the lanes that have a pixel to draw, Math is the index into the Renderers_ tables.
+// With simd_uncached GFX.S is never read back: a full row is one vector store and a partial one
+// stores only its drawn pixels.
+
+static inline void DrawPixels16SIMD (int Math, uint32 Offset, TileVec Main, TileVec Draw, uint8 z1, uint8 z2)
+{
+	TileVec	db = TileLoadZ(GFX.DB + Offset);
+
+	Draw = TileAnd(Draw, TileCmpGt(TileDup(z1), db));
+	if (!TileAny(Draw))
+		return;
+
+	if (Math)
+	{
+		TileVec	sd    = TileCmpEq(TileAnd(TileLoadZ(GFX.SubZBuffer + Offset), TileDup(0x20)), TileDup(0x20));
+		TileVec	fixed = TileDup(GFX.FixedColour);
+		TileVec	sub   = TileSelect(sd, TileLoad(GFX.SubScreen + Offset), fixed);
+
+		switch (Math)
+		{
+			case 1:	// REGMATH(ADD)
+				Main = TileColourAdd(Main, sub);
+				break;
+
+			case 2:	// MATHF1_2(ADD)
+				Main = GFX.ClipColors ? TileColourAdd(Main, fixed) : TileColourAdd1_2(Main, fixed);
+				break;
+
+			case 3:	// MATHS1_2(ADD)
+				Main = GFX.ClipColors ? TileColourAdd(Main, sub) : TileSelect(sd, TileColourAdd1_2(Main, sub), TileColourAdd(Main, fixed));
+				break;
+
+			case 4:	// REGMATH(SUB)
+				Main = TileColourSub(Main, sub);
+				break;
+
+			case 5:	// MATHF1_2(SUB)
+				Main = GFX.ClipColors ? TileColourSub(Main, fixed) : TileColourSub1_2(Main, fixed);
+				break;
+
+			case 6:	// MATHS1_2(SUB)
+				Main = GFX.ClipColors ? TileColourSub(Main, sub) : TileSelect(sd, TileColourSub1_2(Main, sub), TileColourSub(Main, fixed));
+				break;
+		}
+	}
+
+	if (!simd_uncached)
+		TileStore(GFX.S + Offset, TileSelect(Draw, Main, TileLoad(GFX.S + Offset)));
+	else
+	if (TileAll(Draw))
+		TileStore(GFX.S + Offset, Main);
+	else
+	{
+		uint16	Colour[8], Mask[8];
+
+		TileStore(Colour, Main);
+		TileStore(Mask, Draw);
+		for (int x = 0; x < 8; x++)
+		{
+			if (Mask[x])
+				GFX.S[Offset + x] = Colour[x];
+		}
+	}
+
+	TileStoreZ(GFX.DB + Offset, TileSelect(Draw, TileDup(z2), db));
+}
+
+static inline void DrawTile16SIMD (int Math, uint32 Tile, uint32 Offset, uint32 StartLine, uint32 LineCount)
+{
+	uint8	*pCache;
+	uint8	*bp;
+	int32	pitch;
+	uint16	Pix[8], Colour[8];
+
+	GET_CACHED_TILE();
+	if (IS_BLANK_TILE())
+		return;
+	SELECT_PALETTE();
+
+	if (!(Tile & V_FLIP))
+	{
+		bp = pCache + StartLine;
+		pitch = 8;
+	}
+	else
+	{
+		bp = pCache + 56 - StartLine;
+		pitch = -8;
+	}
+
+	for (uint32 l = LineCount; l > 0; l--, bp += pitch, Offset += GFX.PPL)
+	{
+		if (!(Tile & H_FLIP))
+		{
+			for (int x = 0; x < 8; x++)
+				Pix[x] = bp[x];
+		}
+		else
+		{
+			for (int x = 0; x < 8; x++)
+				Pix[x] = bp[7 - x];
+		}
+
+		for (int x = 0; x < 8; x++)
+			Colour[x] = GFX.ScreenColors[Pix[x]];
+
+		TileVec	Draw = TileCmpEq(TileLoad(Pix), TileDup(0));
+		DrawPixels16SIMD(Math, Offset, TileLoad(Colour), TileXor(Draw, TileDup(0xffff)), GFX.Z1, GFX.Z2);
+	}
+}
+
+static inline void DrawBackdrop16SIMD (int Math, uint32 Offset, uint32 Left, uint32 Right)
+{
+	uint32	Span = (Right > Left) ? ((Right - Left) & ~7) : 0;
+
+	GFX.RealScreenColors = IPPU.ScreenColors;
+	GFX.ScreenColors = GFX.ClipColors ? BlackColourMap : GFX.RealScreenColors;
+
+	TileVec	Colour = TileDup(GFX.ScreenColors[0]);
+
+	for (uint32 l = GFX.StartY, o = Offset; l <= GFX.EndY; l++, o += GFX.PPL)
+	{
+		for (uint32 x = Left; x < Left + Span; x += 8)
+			DrawPixels16SIMD(Math, o + x, Colour, TileDup(0xffff), 1, 1);
+	}
+
+	// Whatever is left over is narrower than a vector.
+	if (Left + Span < Right)
+		Renderers_DrawBackdrop16Normal1x1[Math](Offset, Left + Span, Right);
+}
+
+#define TILE_SIMD_RENDERERS(M, NAME) \
+	static void DrawTile16##NAME##SIMD (uint32 Tile, uint32 Offset, uint32 StartLine, uint32 LineCount) \
+	{ \
+		DrawTile16SIMD(M, Tile, Offset, StartLine, LineCount); \
+	} \
+	\
+	static void DrawBackdrop16##NAME##SIMD (uint32 Offset, uint32 Left, uint32 Right) \
+	{ \
+		DrawBackdrop16SIMD(M, Offset, Left, Right); \
+	}
+
+TILE_SIMD_RENDERERS(0, _)
+TILE_SIMD_RENDERERS(1, Add_)
+TILE_SIMD_RENDERERS(2, AddF1_2_)
+TILE_SIMD_RENDERERS(3, AddS1_2_)
+TILE_SIMD_RENDERERS(4, Sub_)
+TILE_SIMD_RENDERERS(5, SubF1_2_)
+TILE_SIMD_RENDERERS(6, SubS1_2_)
+
+#undef TILE_SIMD_RENDERERS
+
+static void (*Renderers_DrawTile16SIMD[7]) (uint32, uint32, uint32, uint32) =
+{
+	DrawTile16_SIMD,
+	DrawTile16Add_SIMD,
+	DrawTile16AddF1_2_SIMD,
+	DrawTile16AddS1_2_SIMD,
+	DrawTile16Sub_SIMD,
+	DrawTile16SubF1_2_SIMD,
+	DrawTile16SubS1_2_SIMD
+};
+
+static void (*Renderers_DrawBackdrop16SIMD[7]) (uint32, uint32, uint32) =
+{
+	DrawBackdrop16_SIMD,
+	DrawBackdrop16Add_SIMD,
+	DrawBackdrop16AddF1_2_SIMD,
+	DrawBackdrop16AddS1_2_SIMD,
+	DrawBackdrop16Sub_SIMD,
+	DrawBackdrop16SubF1_2_SIMD,
+	DrawBackdrop16SubS1_2_SIMD
+};
+
+#endif
+
 /*****************************************************************************/
 #else
 #ifndef NAME2 // Second-level: Get all the NAME1 renderers.
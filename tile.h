@@ -182,5 +182,26 @@
 void S9xInitTileRenderer (void);
 void S9xSelectTileRenderers (int, bool8, bool8);
 void S9xSelectTileConverter (int, bool8, bool8, bool8);
+bool8 S9xInitTileCache (struct STileCache *, uint32);
+void S9xDeinitTileCache (struct STileCache *);
+
+// Tile converters by kind, so the benchmark can compare the vector and scalar versions.
+
+enum
+{
+	TILE_CONVERT_2,
+	TILE_CONVERT_4,
+	TILE_CONVERT_8,
+	TILE_CONVERT_2H_ODD,
+	TILE_CONVERT_4H_ODD,
+	TILE_CONVERT_2H_EVEN,
+	TILE_CONVERT_4H_EVEN,
+	TILE_CONVERT_COUNT
+};
+
+const char * S9xTileConverterSIMDName (void);
+uint8 S9xConvertTile (int, bool8, uint8 *, uint32, uint32);
+void S9xSetTileSIMD (bool8);
+void S9xSetTileScreenUncached (bool8);
 
 #endif
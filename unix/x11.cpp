@@ -250,8 +250,6 @@ static struct GUIData	GUI;
 typedef	std::pair<std::string, std::string>	strpair_t;
 extern	std::vector<strpair_t>				keymaps;
 
-typedef	void (* Blitter) (uint8 *, int, uint8 *, int, int, int);
-
 #ifdef __linux
 // Select seems to be broken in 2.x.x kernels - if a signal interrupts a
 // select system call with a zero timeout, the select call is restarted but